@@ -0,0 +1,235 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdlib.h>
+#include <new>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+
+#include "alloc.hpp"
+#include "util.hpp"
+
+namespace KBX {
+
+namespace {
+
+// counters of the calling thread; trivial types, so operator new may use them any time
+thread_local uint64_t threadAllocations = 0;
+thread_local uint64_t threadBytes = 0;
+thread_local const char* threadSite = NULL;
+
+/// totals of a site; sites are identified by the address of their name literal
+struct SiteCounters {
+  std::atomic< const char* > name;
+  std::atomic< uint64_t > allocations;
+  std::atomic< uint64_t > bytes;
+};
+
+// open addressing without allocations, since it is filled from within operator new
+const size_t SITE_SLOTS = 256;
+SiteCounters sites[SITE_SLOTS];
+const char* const OTHER_SITE = "(other)";
+
+#ifdef KBX_ALLOC_TRACKING
+void countAllocation(size_t size) {
+  threadAllocations++;
+  threadBytes += size;
+  const char* name = threadSite ? threadSite : OTHER_SITE;
+  size_t slot = (reinterpret_cast< uintptr_t >(name) >> 3) % SITE_SLOTS;
+  for (size_t probe = 0; probe < SITE_SLOTS; probe++) {
+    SiteCounters& site = sites[(slot + probe) % SITE_SLOTS];
+    const char* current = site.name.load(std::memory_order_acquire);
+    if (current == NULL) {
+      const char* expected = NULL;
+      if ( !site.name.compare_exchange_strong(expected, name) && expected != name) {
+        continue;
+      }
+    } else if (current != name) {
+      continue;
+    }
+    site.allocations.fetch_add(1, std::memory_order_relaxed);
+    site.bytes.fetch_add(size, std::memory_order_relaxed);
+    return;
+  }
+}
+#endif
+
+} // end anonymous namespace
+
+AllocCounters::AllocCounters()
+    : allocations(0),
+      bytes(0) {
+}
+
+AllocCounters AllocCounters::operator-(const AllocCounters& other) const {
+  AllocCounters diff;
+  diff.allocations = this->allocations - other.allocations;
+  diff.bytes = this->bytes - other.bytes;
+  return diff;
+}
+
+/// true, if allocations are counted in this build
+bool AllocTracking::available() {
+#ifdef KBX_ALLOC_TRACKING
+  return true;
+#else
+  return false;
+#endif
+}
+
+/// allocations of the calling thread since its start
+AllocCounters AllocTracking::thread() {
+  AllocCounters counters;
+  counters.allocations = threadAllocations;
+  counters.bytes = threadBytes;
+  return counters;
+}
+
+/// allocations of all threads by site, most frequent first (one line per site)
+std::string AllocTracking::report() {
+  struct Line {
+    const char* name;
+    uint64_t allocations;
+    uint64_t bytes;
+  };
+  std::vector< Line > lines;
+  for (size_t i = 0; i < SITE_SLOTS; i++) {
+    const char* name = sites[i].name.load(std::memory_order_acquire);
+    if (name) {
+      Line line = {name, sites[i].allocations.load(), sites[i].bytes.load()};
+      lines.push_back(line);
+    }
+  }
+  std::sort(lines.begin(), lines.end(), [](const Line& lhs, const Line& rhs) {
+    return lhs.allocations > rhs.allocations;
+  });
+  std::string text = "";
+  for (size_t i = 0; i < lines.size(); i++) {
+    text += stringprintf("%-24s %12llu allocations %14llu bytes\n", lines[i].name,
+                         static_cast< unsigned long long >(lines[i].allocations),
+                         static_cast< unsigned long long >(lines[i].bytes));
+  }
+  return text;
+}
+
+AllocSite::AllocSite(const char* name)
+    : _parent(threadSite) {
+  threadSite = name;
+}
+
+AllocSite::~AllocSite() {
+  threadSite = this->_parent;
+}
+
+const size_t SearchArena::BLOCK_SIZE;
+
+SearchArena::SearchArena()
+    : _block(0),
+      _offset(0) {
+}
+
+SearchArena::~SearchArena() {
+  for (size_t i = 0; i < this->_blocks.size(); i++) {
+    delete[] this->_blocks[i];
+  }
+}
+
+/// arena of the calling thread
+SearchArena& SearchArena::thread() {
+  static thread_local SearchArena arena;
+  return arena;
+}
+
+/// memory for the given number of bytes, valid until the innermost Scope ends
+/**
+ \param align alignment, a power of 2 not larger than that of max_align_t
+ */
+void* SearchArena::allocate(size_t bytes, size_t align) {
+  for (;;) {
+    if (this->_block < this->_blocks.size()) {
+      size_t offset = (this->_offset + align - 1) & ~(align - 1);
+      if (offset + bytes <= this->_sizes[this->_block]) {
+        this->_offset = offset + bytes;
+        return this->_blocks[this->_block] + offset;
+      }
+      if (this->_offset == 0) {
+        // an unused block too small for this request is replaced by a larger one
+        delete[] this->_blocks[this->_block];
+        this->_sizes[this->_block] = std::max(BLOCK_SIZE, bytes);
+        this->_blocks[this->_block] = new char[this->_sizes[this->_block]];
+        continue;
+      }
+      this->_block++;
+      this->_offset = 0;
+    } else {
+      KBX_ALLOC_SITE("SearchArena");
+      this->_sizes.push_back(std::max(BLOCK_SIZE, bytes));
+      this->_blocks.push_back(new char[this->_sizes.back()]);
+    }
+  }
+}
+
+/// bytes allocated in the open scopes
+size_t SearchArena::used() const {
+  size_t bytes = this->_offset;
+  for (size_t i = 0; i < this->_block && i < this->_sizes.size(); i++) {
+    bytes += this->_sizes[i];
+  }
+  return bytes;
+}
+
+/// bytes of all blocks, used or kept for later
+size_t SearchArena::capacity() const {
+  size_t bytes = 0;
+  for (size_t i = 0; i < this->_sizes.size(); i++) {
+    bytes += this->_sizes[i];
+  }
+  return bytes;
+}
+
+SearchArena::Scope::Scope()
+    : _arena(SearchArena::thread()),
+      _block(_arena._block),
+      _offset(_arena._offset) {
+}
+
+SearchArena::Scope::~Scope() {
+  this->_arena._block = this->_block;
+  this->_arena._offset = this->_offset;
+}
+
+} // end namespace KBX
+
+#ifdef KBX_ALLOC_TRACKING
+
+// replacements of the global allocation functions; the array, nothrow and
+// sized forms of the standard library forward to these two
+void* operator new(size_t size) {
+  KBX::countAllocation(size);
+  void* p = malloc(size ? size : 1);
+  if ( !p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  free(p);
+}
+
+#endif
@@ -0,0 +1,140 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ALLOC__HPP
+#define ALLOC__HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+namespace KBX {
+
+/// number and size of heap allocations
+class AllocCounters {
+  public:
+    AllocCounters();
+    uint64_t allocations;
+    uint64_t bytes;
+    AllocCounters operator-(const AllocCounters& other) const;
+};
+
+/// heap allocation tracking
+/**
+ allocations are only counted in builds with -DKBX_ALLOC_TRACKING=ON,
+ which replace the global operator new; otherwise all counters stay 0
+ and KBX_ALLOC_SITE compiles to nothing. every thread counts for itself.
+ allocations are attributed to the innermost active KBX_ALLOC_SITE of
+ their thread (or to '(other)') and summed up over all threads by site.
+ */
+class AllocTracking {
+  public:
+    static bool available();
+    static AllocCounters thread();
+    static std::string report();
+};
+
+/// attributes the allocations of the calling thread to a named site while in scope
+class AllocSite {
+  public:
+    AllocSite(const char* name);
+    ~AllocSite();
+  private:
+    const char* _parent;
+};
+
+/// bump allocator for the transient data of the searches of the calling thread
+/**
+ memory is taken from blocks of the thread's arena and given back all at
+ once, when the innermost Scope ends (i.e. in O(1), no matter how much was
+ allocated). the blocks are kept for the next search, so a thread stops
+ touching the heap after its first searches and its memory use stays flat.
+ containers use the arena via ArenaAllocator; they must not outlive the
+ Scope they were filled in.
+ */
+class SearchArena {
+  public:
+    static SearchArena& thread();
+    void* allocate(size_t bytes, size_t align);
+    size_t used() const;
+    size_t capacity() const;
+    /// everything allocated from the thread's arena while in scope is released with it
+    class Scope {
+      public:
+        Scope();
+        ~Scope();
+      private:
+        SearchArena& _arena;
+        size_t _block;
+        size_t _offset;
+    };
+  private:
+    SearchArena();
+    ~SearchArena();
+    SearchArena(const SearchArena&);
+    SearchArena& operator=(const SearchArena&);
+    static const size_t BLOCK_SIZE = 64 * 1024;
+    std::vector< char* > _blocks;
+    std::vector< size_t > _sizes;
+    // position of the next allocation
+    size_t _block;
+    size_t _offset;
+};
+
+/// allocator of the standard containers, taking memory from the thread's SearchArena
+/**
+ deallocate does nothing; memory is released with the SearchArena::Scope.
+ */
+template< class T >
+class ArenaAllocator {
+  public:
+    typedef T value_type;
+    ArenaAllocator() {
+    }
+    template< class U >
+    ArenaAllocator(const ArenaAllocator< U >&) {
+    }
+    T* allocate(size_t n) {
+      return static_cast< T* >(SearchArena::thread().allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T*, size_t) {
+    }
+};
+
+template< class T, class U >
+bool operator==(const ArenaAllocator< T >&, const ArenaAllocator< U >&) {
+  return true;
+}
+
+template< class T, class U >
+bool operator!=(const ArenaAllocator< T >&, const ArenaAllocator< U >&) {
+  return false;
+}
+
+} // end namespace KBX
+
+#ifdef KBX_ALLOC_TRACKING
+#define KBX_ALLOC_CONCAT2(a, b) a ## b
+#define KBX_ALLOC_CONCAT(a, b) KBX_ALLOC_CONCAT2(a, b)
+/// name must be a string literal
+#define KBX_ALLOC_SITE(name) KBX::AllocSite KBX_ALLOC_CONCAT(kbxAllocSite, __LINE__)(name)
+#else
+#define KBX_ALLOC_SITE(name) do {} while (0)
+#endif
+
+#endif
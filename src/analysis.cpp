@@ -0,0 +1,157 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <dirent.h>
+#include <sys/stat.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+
+#include "analysis.hpp"
+#include "util.hpp"
+
+namespace KBX {
+
+/// annotate every move of the game's history
+/**
+ the game is taken back to its start and replayed move by move. before
+ every move, the position is searched to the given depth; the played
+ move is rated by a search one ply shorter from the opponent's view, so
+ both ratings are comparable. afterwards, the game is at its original
+ position again.
+ \param game game with history, e.g. loaded from a savegame
+ \param depth search depth in plies
+ \returns one annotation per move, in order of play
+ */
+std::vector< MoveAnnotation > annotateGame(Game& game, int depth) {
+  std::vector< MoveAnnotation > annotations;
+  size_t nMoves = 0;
+  while (game.undoMove()) {
+    nMoves++;
+  }
+  for (size_t ply = 0; ply < nMoves; ply++) {
+    MoveAnnotation a;
+    a.ply = ply;
+    a.color = game.getNext();
+    Evaluation best = game.searchBestMove(depth);
+    Move played = game.redoMove();
+    // notation of a move needs the position before it
+    game.undoMove();
+    a.move = game.moveToString(played);
+    // without a move, all moves are lost anyway
+    a.best = best.move ? game.moveToString(best.move) : a.move;
+    a.bestScore = best.rating;
+    game.redoMove();
+    if (a.move == a.best) {
+      a.score = a.bestScore;
+    } else {
+      a.score = - game.getStrategy().patience * game.evaluatePosition(depth - 1);
+    }
+    a.error = std::max(0.0f, a.bestScore - a.score);
+    annotations.push_back(a);
+  }
+  return annotations;
+}
+
+/// list of savegames: files as given, directories by their .kbx files (sorted by name)
+std::vector< std::string > collectSavegames(const std::vector< std::string >& paths) {
+  std::vector< std::string > files;
+  for (size_t i = 0; i < paths.size(); i++) {
+    struct stat info;
+    if (stat(paths[i].c_str(), &info) != 0 || !S_ISDIR(info.st_mode)) {
+      files.push_back(paths[i]);
+      continue;
+    }
+    std::vector< std::string > dirFiles;
+    DIR* dir = opendir(paths[i].c_str());
+    if ( !dir) {
+      continue;
+    }
+    for (struct dirent* entry = readdir(dir); entry; entry = readdir(dir)) {
+      std::string name(entry->d_name);
+      if (endsWith(name, ".kbx")) {
+        dirFiles.push_back(paths[i] + "/" + name);
+      }
+    }
+    closedir(dir);
+    std::sort(dirFiles.begin(), dirFiles.end());
+    files.insert(files.end(), dirFiles.begin(), dirFiles.end());
+  }
+  return files;
+}
+
+/// annotate all games and write a tab-separated report
+/**
+ games are distributed over nThreads workers; the report lists them in
+ the given order, one line per move:
+   file, ply, color, move, score, best move, best score, error
+ games that cannot be read are reported on stderr and skipped.
+ \param seed random seed of the searches (see Game::setRandomSeed); with a
+             seed other than 0 the report does not depend on nThreads
+ \returns false, if the report cannot be written
+ */
+bool analyzeGames(const std::vector< std::string >& files, const std::string& report, int depth, size_t nThreads,
+                  uint64_t seed) {
+  std::vector< std::string > lines(files.size());
+  std::atomic< size_t > next(0);
+  std::vector< std::thread > workers;
+  for (size_t t = 0; t < std::max(size_t(1), nThreads); t++) {
+    workers.push_back(std::thread([&]() {
+      for (size_t i = next++; i < files.size(); i = next++) {
+        Game game((GameConfig()));
+        std::ifstream in(files[i]);
+        if (in.is_open()) {
+          in >> game;
+        }
+        if ( !in.is_open() || in.fail()) {
+          std::cerr << "cannot read '" << files[i] << "'" << std::endl;
+          continue;
+        }
+        game.setRandomSeed(seed);
+        std::vector< MoveAnnotation > annotations = annotateGame(game, depth);
+        std::stringstream out;
+        for (size_t m = 0; m < annotations.size(); m++) {
+          const MoveAnnotation& a = annotations[m];
+          // adding 0 turns the -0 of negated ratings into 0
+          out << files[i] << "\t" << a.ply << "\t" << (a.color == WHITE ? "white" : "black") << "\t" << a.move << "\t"
+              << stringprintf("%.4f", a.score + 0.0f) << "\t" << a.best << "\t" << stringprintf("%.4f", a.bestScore + 0.0f)
+              << "\t" << stringprintf("%.4f", a.error) << "\n";
+        }
+        lines[i] = out.str();
+      }
+    }));
+  }
+  for (size_t t = 0; t < workers.size(); t++) {
+    workers[t].join();
+  }
+  std::ofstream out(report);
+  out << "# file\tply\tcolor\tmove\tscore\tbest\tbest_score\terror\n";
+  for (size_t i = 0; i < lines.size(); i++) {
+    out << lines[i];
+  }
+  out.close();
+  if (out.fail()) {
+    std::cerr << "cannot write '" << report << "'" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // end namespace KBX
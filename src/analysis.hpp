@@ -0,0 +1,50 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ANALYSIS__HPP
+#define ANALYSIS__HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "engine.hpp"
+
+namespace KBX {
+
+/// engine verdict on a single move of a game
+class MoveAnnotation {
+  public:
+    size_t ply;
+    PlayColor color;
+    std::string move;
+    // rating of the played move and of the best move, for the moving player
+    float score;
+    std::string best;
+    float bestScore;
+    // rating lost by the played move (0: best move or equally good)
+    float error;
+};
+
+std::vector< MoveAnnotation > annotateGame(Game& game, int depth);
+std::vector< std::string > collectSavegames(const std::vector< std::string >& paths);
+bool analyzeGames(const std::vector< std::string >& files, const std::string& report, int depth, size_t nThreads,
+                  uint64_t seed = 0);
+
+} // end namespace KBX
+#endif
@@ -0,0 +1,212 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+
+#include "book.hpp"
+#include "util.hpp"
+
+namespace KBX {
+
+static_assert(sizeof(OpeningBook::Entry) == 16, "opening book entries must be packed to 16 bytes");
+
+const char OpeningBook::_magic[8] = {'K', 'B', 'X', 'B', 'O', 'O', 'K', '2'};
+
+OpeningBook::Entry::Entry()
+    : key(0),
+      x(0),
+      y(0),
+      dx(0),
+      dy(0),
+      firstX(0),
+      reserved(0),
+      weight(0) {
+}
+
+OpeningBook::Entry::Entry(uint64_t key, int x, int y, RelativeMove rel, uint16_t weight)
+    : key(key),
+      x(x),
+      y(y),
+      dx(rel.dx),
+      dy(rel.dy),
+      firstX(rel.firstX),
+      reserved(0),
+      weight(weight) {
+}
+
+RelativeMove OpeningBook::Entry::rel() const {
+  return RelativeMove(this->dx, this->dy, this->firstX);
+}
+
+/// entries are sorted by key, moves of the same position by descending weight
+bool OpeningBook::Entry::operator<(const Entry& other) const {
+  if (this->key != other.key) {
+    return this->key < other.key;
+  }
+  return this->weight > other.weight;
+}
+
+OpeningBook::OpeningBook()
+    : _mapping(NULL),
+      _mappingSize(0),
+      _entries(NULL),
+      _nEntries(0) {
+}
+
+OpeningBook::~OpeningBook() {
+  this->close();
+}
+
+/// map book file into memory
+/**
+ \returns true, if the file has been mapped successfully
+ */
+bool OpeningBook::open(const std::string& filename) {
+  Logger log("book");
+  this->close();
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    log.warning("cannot open opening book '" + filename + "'");
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(_magic) + sizeof(uint64_t)) {
+    log.warning("opening book '" + filename + "' is too small");
+    ::close(fd);
+    return false;
+  }
+  void* mapping = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  // the mapping stays valid after closing the descriptor
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    log.warning("cannot map opening book '" + filename + "'");
+    return false;
+  }
+  const char* data = (const char*) mapping;
+  uint64_t nEntries;
+  memcpy( &nEntries, data + sizeof(_magic), sizeof(nEntries));
+  size_t expectedSize = sizeof(_magic) + sizeof(nEntries) + nEntries * sizeof(Entry);
+  if (memcmp(data, _magic, sizeof(_magic)) != 0 || expectedSize != (size_t) st.st_size) {
+    log.warning("'" + filename + "' is not a valid opening book");
+    munmap(mapping, st.st_size);
+    return false;
+  }
+  this->_mapping = mapping;
+  this->_mappingSize = st.st_size;
+  this->_entries = (const Entry*) (data + sizeof(_magic) + sizeof(nEntries));
+  this->_nEntries = nEntries;
+  log.info(stringprintf("opened opening book with %d entries", (int) nEntries));
+  return true;
+}
+
+/// unmap book file
+void OpeningBook::close() {
+  if (this->_mapping) {
+    munmap(this->_mapping, this->_mappingSize);
+  }
+  this->_mapping = NULL;
+  this->_mappingSize = 0;
+  this->_entries = NULL;
+  this->_nEntries = 0;
+}
+
+bool OpeningBook::isOpen() const {
+  return (this->_mapping != NULL);
+}
+
+/// return number of stored moves
+size_t OpeningBook::size() const {
+  return this->_nEntries;
+}
+
+/// return all book entries for the position with the given hash
+std::vector< OpeningBook::Entry > OpeningBook::lookup(uint64_t key) const {
+  std::vector< Entry > result;
+  Entry probe;
+  probe.key = key;
+  // weight 0xffff sorts first among entries with the same key
+  probe.weight = 0xffff;
+  const Entry* end = this->_entries + this->_nEntries;
+  for (const Entry* e = std::lower_bound(this->_entries, end, probe); e != end && e->key == key; e++) {
+    result.push_back( *e);
+  }
+  return result;
+}
+
+/// select a book move for the current position
+/**
+ \param random source of the random choice (see Game::setRandomSeed)
+ \returns a move chosen randomly with probability proportional to its weight;
+          an invalid move (dieIndex == -1) if the position is not in the book
+ */
+Move OpeningBook::probe(Game& game, std::mt19937_64& random) const {
+  if ( !this->isOpen()) {
+    return Move();
+  }
+  std::vector< Entry > entries = this->lookup(game.canonicalHash());
+  // entries are stored for the canonical form and must be rotated back otherwise
+  bool rotated = !game.isCanonical();
+  std::vector< Move > moves;
+  std::vector< double > weights;
+  for (size_t i = 0; i < entries.size(); i++) {
+    int x = rotated ? 8 - entries[i].x : entries[i].x;
+    int y = rotated ? 8 - entries[i].y : entries[i].y;
+    int dieId = game.getDieId(x, y);
+    if (dieId == CLEAR) {
+      continue;
+    }
+    // guard against hash collisions
+    Move mv(dieId, rotated ? entries[i].rel().rotate() : entries[i].rel());
+    if (game.moveIsValid(mv)) {
+      moves.push_back(mv);
+      weights.push_back(entries[i].weight);
+    }
+  }
+  if (moves.empty()) {
+    return Move();
+  }
+  return moves[weightedRandomIndex(weights, random)];
+}
+
+/// sort entries and write them to a book file
+/**
+ \returns true, if the file has been written successfully
+ */
+bool OpeningBook::write(const std::string& filename, std::vector< Entry > entries) {
+  std::sort(entries.begin(), entries.end());
+  FILE* out = fopen(filename.c_str(), "wb");
+  if ( !out) {
+    Logger("book").error("cannot write opening book '" + filename + "'");
+    return false;
+  }
+  uint64_t nEntries = entries.size();
+  bool ok = (fwrite(_magic, sizeof(_magic), 1, out) == 1);
+  ok = ok && (fwrite( &nEntries, sizeof(nEntries), 1, out) == 1);
+  if (nEntries > 0) {
+    ok = ok && (fwrite( &entries[0], sizeof(Entry), nEntries, out) == nEntries);
+  }
+  ok = (fclose(out) == 0) && ok;
+  return ok;
+}
+
+} // end namespace KBX
@@ -0,0 +1,82 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef BOOK__HPP
+#define BOOK__HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "engine.hpp"
+
+namespace KBX {
+
+/// opening book, mapping position hashes to weighted moves
+/**
+ the book file is a header followed by a list of fixed-size entries,
+ sorted by position hash. it is memory-mapped read-only, so probing
+ costs a binary search and no copying. moves are stored in board
+ coordinates (field of the moving die), not by die index.
+ positions and moves are stored in their canonical form (see Game::canonicalHash).
+ */
+class OpeningBook {
+  public:
+    class Entry {
+      public:
+        uint64_t key;
+        uint8_t x;
+        uint8_t y;
+        int8_t dx;
+        int8_t dy;
+        uint8_t firstX;
+        uint8_t reserved;
+        uint16_t weight;
+        Entry();
+        Entry(uint64_t key, int x, int y, RelativeMove rel, uint16_t weight);
+        RelativeMove rel() const;
+        bool operator<(const Entry& other) const;
+    };
+
+    OpeningBook();
+    ~OpeningBook();
+
+    bool open(const std::string& filename);
+    void close();
+    bool isOpen() const;
+    size_t size() const;
+
+    std::vector< Entry > lookup(uint64_t key) const;
+    Move probe(Game& game, std::mt19937_64& random) const;
+
+    static bool write(const std::string& filename, std::vector< Entry > entries);
+
+  private:
+    // copying would unmap the file twice
+    OpeningBook(const OpeningBook& other);
+    OpeningBook& operator=(const OpeningBook& other);
+
+    static const char _magic[8];
+    void* _mapping;
+    size_t _mappingSize;
+    const Entry* _entries;
+    size_t _nEntries;
+};
+
+} // end namespace KBX
+#endif
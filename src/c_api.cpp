@@ -0,0 +1,182 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string.h>
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "kubix_engine.h"
+#include "engine.hpp"
+#include "util.hpp"
+
+struct kbx_game {
+    KBX::Game game;
+    kbx_game()
+        : game((GameConfig())) {
+    }
+};
+
+namespace {
+
+/// copy text to buffer like snprintf, return length of text
+size_t copyString(const std::string& text, char* buffer, size_t size) {
+  if (buffer && size > 0) {
+    size_t n = std::min(text.size(), size - 1);
+    memcpy(buffer, text.data(), n);
+    buffer[n] = '\0';
+  }
+  return text.size();
+}
+
+} // end anonymous namespace
+
+// the engine reports errors by exceptions, which must not cross the C interface
+
+const char* kbx_version(void) {
+  return "0.1";
+}
+
+kbx_game* kbx_game_new(void) {
+  try {
+    return new kbx_game();
+  } catch (...) {
+    return NULL;
+  }
+}
+
+kbx_game* kbx_game_load(const char* savegame) {
+  if ( !savegame) {
+    return NULL;
+  }
+  kbx_game* game = NULL;
+  try {
+    game = new kbx_game();
+    std::stringstream in(savegame);
+    in >> game->game;
+    if (in.fail()) {
+      delete game;
+      return NULL;
+    }
+    return game;
+  } catch (...) {
+    delete game;
+    return NULL;
+  }
+}
+
+void kbx_game_free(kbx_game* game) {
+  delete game;
+}
+
+size_t kbx_game_save(kbx_game* game, char* buffer, size_t size) {
+  try {
+    std::stringstream out;
+    out << game->game;
+    return copyString(out.str(), buffer, size);
+  } catch (...) {
+    return copyString("", buffer, size);
+  }
+}
+
+int kbx_game_next(kbx_game* game) {
+  return game->game.getNext();
+}
+
+int kbx_game_winner(kbx_game* game) {
+  return game->game.getWinner();
+}
+
+int kbx_game_is_draw(kbx_game* game) {
+  return game->game.isDraw() ? 1 : 0;
+}
+
+uint64_t kbx_game_hash(kbx_game* game) {
+  return game->game.hash();
+}
+
+size_t kbx_game_moves(kbx_game* game, char* buffer, size_t size) {
+  try {
+    std::string text;
+    std::vector< KBX::Move > moves = game->game.validMoves();
+    for (size_t i = 0; i < moves.size(); i++) {
+      if (i > 0) {
+        text += " ";
+      }
+      text += game->game.moveToString(moves[i]);
+    }
+    return copyString(text, buffer, size);
+  } catch (...) {
+    return copyString("", buffer, size);
+  }
+}
+
+int kbx_game_play(kbx_game* game, const char* move) {
+  if ( !move) {
+    return -1;
+  }
+  try {
+    KBX::Move mv = game->game.moveFromString(move);
+    if ( !mv || game->game.getDie(mv.dieIndex).getColor() != game->game.getNext() || !game->game.moveIsValid(mv)) {
+      return -1;
+    }
+    game->game.makeMove(mv, true);
+    return 0;
+  } catch (...) {
+    return -1;
+  }
+}
+
+int kbx_game_undo(kbx_game* game) {
+  try {
+    return game->game.undoMove() ? 0 : -1;
+  } catch (...) {
+    return -1;
+  }
+}
+
+int kbx_game_search(kbx_game* game, int depth, char* move, size_t size, float* rating) {
+  try {
+    if (depth < 1 || game->game.getWinner() != KBX::NONE_OF_BOTH || game->game.validMoves().empty()) {
+      return -1;
+    }
+    KBX::Evaluation eval = game->game.searchBestMove(depth);
+    if ( !eval.move) {
+      return -1;
+    }
+    copyString(game->game.moveToString(eval.move), move, size);
+    if (rating) {
+      *rating = eval.rating;
+    }
+    return 0;
+  } catch (...) {
+    return -1;
+  }
+}
+
+void kbx_game_set_seed(kbx_game* game, uint64_t seed) {
+  game->game.setRandomSeed(seed);
+}
+
+uint64_t kbx_game_perft(kbx_game* game, int depth) {
+  try {
+    return game->game.perft(depth);
+  } catch (...) {
+    return 0;
+  }
+}
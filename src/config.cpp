@@ -1,82 +1,81 @@
 #include "config.hpp"
+#include "engine.hpp"
 
-
-void GameConfig::setAiDepth(size_t aiDepth){
-  this->_aiDepth = aiDepth;
-}
-
-size_t GameConfig::getAiDepth() const {
-  return this->_aiDepth;
+Config::Config(QObject * parent)
+    // call parent constructor with predefined organization/application strings
+    // (setting these to some value is necessary)
+  : QSettings("lettis", "Kubix", parent) {
 }
 
-KBX::PlayMode GameConfig::getPlayMode() const {
-  return this->_playMode;
+void Config::setValue(const QString & key, const QVariant & value) {
+  // call parent setValue
+  QSettings::setValue(key, value);
+  // and emit 'changed' signal afterwards
+  emit this->changed();
 }
 
-void GameConfig::setPlayMode(KBX::PlayMode mode){
-  this->_playMode = mode;
+void Config::setAiDepth(size_t aiDepth){
+  this->setValue("game/aiDepth", (unsigned int) aiDepth);
 }
 
-void GameConfig::setAiStrategy(KBX::Strategy s){
-  this->_aiStrategy = s;
+size_t Config::getAiDepth() const {
+  size_t aiDepth = this->value("game/aiDepth").toUInt();
+  return aiDepth;
 }
 
-KBX::Strategy GameConfig::getAiStrategy() const {
-  return this->_aiStrategy;
-}
+// node budget and time cap are stored per difficulty level;
+// the setters change the entry of the current level
 
-void GameConfig::setAllowUndoRedo(bool allow){
-  this->_allowUndoRedo = allow;
+void Config::setAiNodeBudget(uint64_t nodes){
+  this->setValue(QString("difficulty/%1/nodes").arg(this->getAiDepth()), (qulonglong) nodes);
 }
 
-bool GameConfig::getAllowUndoRedo() const {
-  return this->_allowUndoRedo;
+uint64_t Config::getAiNodeBudget() const {
+  return this->value(QString("difficulty/%1/nodes").arg(this->getAiDepth()), 0).toULongLong();
 }
 
-GameConfig::GameConfig(const GameConfig& other) :
-  _aiDepth(other.getAiDepth()),
-  _allowUndoRedo(other.getAllowUndoRedo()),
-  _aiStrategy(other.getAiStrategy()),
-  _playMode(other.getPlayMode())
-{
+void Config::setAiTimeLimit(double seconds){
+  this->setValue(QString("difficulty/%1/timeLimit").arg(this->getAiDepth()), seconds);
 }
 
-GameConfig::GameConfig(const GameConfig* other) :
-  _aiDepth(other ? other->getAiDepth() : 1),
-  _allowUndoRedo(other ? other->getAllowUndoRedo() : true),
-  _aiStrategy(other ? other->getAiStrategy() : KBX::Strategy()),
-  _playMode(other ? other->getPlayMode() : KBX::HUMAN_AI)
-{
+double Config::getAiTimeLimit() const {
+  return this->value(QString("difficulty/%1/timeLimit").arg(this->getAiDepth()), 0.0).toDouble();
 }
 
-GameConfig::GameConfig() :
-  _aiDepth(1),
-  _allowUndoRedo(true),
-  _aiStrategy(),
-  _playMode(KBX::HUMAN_AI)
-{
+bool Config::difficultyCalibrated() const {
+  return this->contains("engine/nodesPerSecond");
 }
 
-Config::Config(QObject * parent)
-    // call parent constructor with predefined organization/application strings
-    // (setting these to some value is necessary)
-  : QSettings("lettis", "Kubix", parent) {
-}
-
-void Config::setValue(const QString & key, const QVariant & value) {
-  // call parent setValue
-  QSettings::setValue(key, value);
-  // and emit 'changed' signal afterwards
-  emit this->changed();
+/// measure search speed of this machine and derive the difficulty levels from it
+/**
+ takes about half a second; the result is stored, so this is only
+ done on the first start (or with --calibrate).
+ */
+void Config::calibrateDifficulty(){
+  double nodesPerSecond = KBX::DifficultyLevel::measureNodesPerSecond(0.5);
+  std::vector< KBX::DifficultyLevel > levels = KBX::DifficultyLevel::calibrate(nodesPerSecond);
+  this->setValue("engine/nodesPerSecond", nodesPerSecond);
+  for (size_t i = 0; i < levels.size(); i++) {
+    this->setValue(QString("difficulty/%1/nodes").arg(i+1), (qulonglong) levels[i].nodes);
+    this->setValue(QString("difficulty/%1/timeLimit").arg(i+1), levels[i].seconds);
+  }
+  // keep the previous choice, if it is still a valid level
+  size_t level = this->getAiDepth();
+  if (level < 1) {
+    this->setAiDepth(1);
+  } else if (level > levels.size()) {
+    this->setAiDepth(levels.size());
+  }
 }
 
-void Config::setAiDepth(size_t aiDepth){
-  this->setValue("game/aiDepth", (unsigned int) aiDepth);
+void Config::setRepetitionDraw(size_t repetitions){
+  this->setValue("game/repetitionDraw", (unsigned int) repetitions);
 }
 
-size_t Config::getAiDepth() const {
-  size_t aiDepth = this->value("game/aiDepth").toUInt();
-  return aiDepth;
+size_t Config::getRepetitionDraw() const {
+  // threefold repetition, if nothing has been configured yet
+  size_t repetitions = this->value("game/repetitionDraw", 3).toUInt();
+  return repetitions;
 }
 
 void Config::setAllowUndoRedo(bool allow){
@@ -96,6 +95,8 @@ KBX::PlayMode Config::getPlayMode() const {
     return KBX::AI_HUMAN;
   } else if(val == "HUMAN_HUMAN"){
     return KBX::HUMAN_HUMAN;
+  } else if(val == "AI_AI"){
+    return KBX::AI_AI;
   } else {
     return KBX::HUMAN_AI;
   }
@@ -113,6 +114,9 @@ void Config::setPlayMode(KBX::PlayMode mode){
     case KBX::HUMAN_HUMAN:
       setting = QString("HUMAN_HUMAN");
       break;
+    case KBX::AI_AI:
+      setting = QString("AI_AI");
+      break;
     default:
       setting = QString("HUMAN_AI");
   }
@@ -3,34 +3,8 @@
 
 #include <QSettings>
 
-#include "global.hpp"
+#include "game_config.hpp"
 
-class GameConfig {
-  protected:
-    size_t _aiDepth;
-    bool _allowUndoRedo;
-    KBX::Strategy _aiStrategy;
-    KBX::PlayMode _playMode;
-
-  public:
-    GameConfig();
-    GameConfig(const GameConfig& other);
-    GameConfig(const GameConfig* other);
-
-    virtual void setAllowUndoRedo(bool allow);
-    virtual bool getAllowUndoRedo() const;
-
-    virtual void setAiStrategy(KBX::Strategy s);
-    virtual KBX::Strategy getAiStrategy() const;
-
-    virtual void setAiDepth(size_t aiDepth);
-    virtual size_t getAiDepth() const;
-    
-    virtual void setPlayMode(KBX::PlayMode mode);
-    virtual KBX::PlayMode getPlayMode() const;
-
-};
-  
 class Config: public QSettings, public GameConfig {
   Q_OBJECT
 
@@ -42,9 +16,22 @@ class Config: public QSettings, public GameConfig {
     void setAllowUndoRedo(bool allow) override;
     bool getAllowUndoRedo() const override;
 
+    // with calibrated difficulty levels, aiDepth is the level (1..KBX::DifficultyLevel::COUNT)
     void setAiDepth(size_t aiDepth) override;
     size_t getAiDepth() const override;
 
+    void setAiNodeBudget(uint64_t nodes) override;
+    uint64_t getAiNodeBudget() const override;
+
+    void setAiTimeLimit(double seconds) override;
+    double getAiTimeLimit() const override;
+
+    bool difficultyCalibrated() const;
+    void calibrateDifficulty();
+
+    void setRepetitionDraw(size_t repetitions) override;
+    size_t getRepetitionDraw() const override;
+
     void setPlayMode(KBX::PlayMode mode) override;
     KBX::PlayMode getPlayMode() const override;
 
@@ -25,9 +25,15 @@
 #include <sstream>
 
 #include "engine.hpp"
-#include "tools.hpp"
+#include "book.hpp"
+#include "util.hpp"
+#include "trace.hpp"
+#include "alloc.hpp"
 
 namespace KBX {
+/// number of buckets of the repetition filter (must be a power of two)
+static const size_t REPETITION_FILTER_SIZE = 4096;
+
 /// switch color from BLACK to WHITE and vice versa
 PlayColor inverse(PlayColor color) {
   switch (color) {
@@ -44,14 +50,16 @@ PlayColor inverse(PlayColor color) {
 Strategy::Strategy()
   : name("default"),
     coeffDiceRatio(1.),
-    patience(.95)
+    patience(.95),
+    randomness(0.)
 {
 }
 
 Strategy::Strategy(const Strategy& other)
   : name(other.name),
     coeffDiceRatio(other.coeffDiceRatio),
-    patience(other.patience)
+    patience(other.patience),
+    randomness(other.randomness)
 {
 }
 
@@ -61,6 +69,16 @@ void Strategy::print() const {
   std::cout << "patience: " << this->patience << std::endl;
 }
 
+/// return coefficients of the rating functions, in the order of Game::ratingTerms
+std::vector< double > Strategy::ratingWeights() const {
+  return std::vector< double >(1, this->coeffDiceRatio);
+}
+
+/// set coefficients of the rating functions, in the order of Game::ratingTerms
+void Strategy::setRatingWeights(const std::vector< double >& weights) {
+  this->coeffDiceRatio = weights.at(0);
+}
+
 /// initialize a move
 RelativeMove::RelativeMove()
     : dx(0),
@@ -77,6 +95,11 @@ RelativeMove RelativeMove::invert() {
   return RelativeMove( -this->dx, -this->dy, !this->firstX);
 }
 
+/// rotate the move by 180 degrees (ie the same move as seen from the opponent's side)
+RelativeMove RelativeMove::rotate() {
+  return RelativeMove( -this->dx, -this->dy, this->firstX);
+}
+
 bool RelativeMove::operator==(const RelativeMove& other) {
   if ((this->dx == other.dx) && (this->dy == other.dy) && (this->firstX == other.firstX)) {
     return true;
@@ -191,6 +214,34 @@ const size_t DieState::_state[26][5] = {
     {6, 14, 9, 7, 17}, {1, 24, 24, 24, 24} // king's die
     , {0, 25, 25, 25, 25} // state == die got killed
 };
+/// save die states for the board rotated by 180 degrees
+const std::vector< size_t > DieState::rotatedStates = initRotatedStates();
+/// calculate the die state of every orientation after rotating the board by 180 degrees
+/**
+ rotating the board by 180 degrees turns every die around its vertical axis:
+ the value on top stays the same, north and south as well as east and west
+ get swapped. the rotated state is thus the one with the same value that shows
+ (after one step north/east) what the original state shows after one step south/west.
+ together with swapping the colors, this maps the starting setup onto itself.
+ (a left-right mirror of the board has no such counterpart: mirrored dice
+ would have to be rotated to a state of opposite handedness, which does not exist.)
+ */
+const std::vector< size_t > DieState::initRotatedStates() {
+  std::vector< size_t > rotated(26);
+  for (size_t s = 0; s < 24; s++) {
+    for (size_t r = 0; r < 24; r++) {
+      if (_state[r][VALUE] == _state[s][VALUE]
+          && _state[_state[r][NORTH]][VALUE] == _state[_state[s][SOUTH]][VALUE]
+          && _state[_state[r][EAST]][VALUE] == _state[_state[s][WEST]][VALUE]) {
+        rotated[s] = r;
+      }
+    }
+  }
+  // king's die and dead dice look the same from every side
+  rotated[24] = 24;
+  rotated[DEAD] = DEAD;
+  return rotated;
+}
 /// set state to the one you get, when moving in given direction
 void DieState::moveOneStep(size_t direction) {
   this->_curState = this->_state[this->_curState][direction];
@@ -262,6 +313,230 @@ Evaluation::Evaluation(float rating, Move move)
       move(move) {
 }
 
+const size_t SearchStats::CUTOFF_SLOTS;
+
+SearchStats::SearchStats()
+    : cutoffsByMove(CUTOFF_SLOTS, 0) {
+  this->reset();
+}
+
+void SearchStats::reset() {
+  this->nodes = 0;
+  this->leaves = 0;
+  std::fill(this->cutoffsByMove.begin(), this->cutoffsByMove.end(), 0);
+  this->hashProbes = 0;
+  this->hashHits = 0;
+  this->maxDepth = 0;
+  this->allocations = 0;
+  this->allocatedBytes = 0;
+  this->iterations.clear();
+}
+
+/// add counters of another game, e.g. of a search on another thread
+void SearchStats::merge(const SearchStats& other) {
+  this->nodes += other.nodes;
+  this->leaves += other.leaves;
+  for (size_t i = 0; i < CUTOFF_SLOTS; i++) {
+    this->cutoffsByMove[i] += other.cutoffsByMove[i];
+  }
+  this->hashProbes += other.hashProbes;
+  this->hashHits += other.hashHits;
+  this->maxDepth = std::max(this->maxDepth, other.maxDepth);
+  this->allocations += other.allocations;
+  this->allocatedBytes += other.allocatedBytes;
+  this->iterations.insert(this->iterations.end(), other.iterations.begin(), other.iterations.end());
+}
+
+uint64_t SearchStats::cutoffs() const {
+  uint64_t n = 0;
+  for (size_t i = 0; i < CUTOFF_SLOTS; i++) {
+    n += this->cutoffsByMove[i];
+  }
+  return n;
+}
+
+/// total time of all iterations
+double SearchStats::seconds() const {
+  double s = 0.0;
+  for (size_t i = 0; i < this->iterations.size(); i++) {
+    s += this->iterations[i].seconds;
+  }
+  return s;
+}
+
+double SearchStats::nodesPerSecond() const {
+  double s = this->seconds();
+  return (s > 0.0) ? this->nodes / s : 0.0;
+}
+
+/// one line for status bars and logs
+std::string SearchStats::summary() const {
+  uint64_t nCutoffs = this->cutoffs();
+  std::string allocs = "";
+  if (AllocTracking::available()) {
+    allocs = stringprintf(", %llu allocations (%.3f per node, %llu bytes)",
+                          static_cast< unsigned long long >(this->allocations),
+                          this->nodes > 0 ? static_cast< double >(this->allocations) / this->nodes : 0.0,
+                          static_cast< unsigned long long >(this->allocatedBytes));
+  }
+  return stringprintf("depth %d, %llu nodes (%llu leaves), %.0f kN/s, %.2f s, %llu cutoffs (%.0f%% by 1st move), "
+                      "%llu/%llu repetitions", this->maxDepth, static_cast< unsigned long long >(this->nodes),
+                      static_cast< unsigned long long >(this->leaves), this->nodesPerSecond() / 1000.0, this->seconds(),
+                      static_cast< unsigned long long >(nCutoffs),
+                      nCutoffs > 0 ? 100.0 * this->cutoffsByMove[0] / nCutoffs : 0.0,
+                      static_cast< unsigned long long >(this->hashHits),
+                      static_cast< unsigned long long >(this->hashProbes)) + allocs;
+}
+
+/// no limits: search until finished
+SearchLimits::SearchLimits()
+    : nodes(0),
+      deadline(std::chrono::steady_clock::time_point::max()),
+      stop(NULL) {
+}
+
+namespace {
+
+/// move as 32 bit value: die index + 1, dx + 8, dy + 8 and firstX in one byte each
+uint32_t packMove(Move move) {
+  return (static_cast< uint32_t >(move.dieIndex + 1) << 24) | (static_cast< uint32_t >(move.rel.dx + 8) << 16)
+      | (static_cast< uint32_t >(move.rel.dy + 8) << 8) | (move.rel.firstX ? 1 : 0);
+}
+
+Move unpackMove(uint32_t packed) {
+  return Move(static_cast< int >(packed >> 24) - 1,
+              RelativeMove(static_cast< int >((packed >> 16) & 0xff) - 8, static_cast< int >((packed >> 8) & 0xff) - 8,
+                           (packed & 1) != 0));
+}
+
+} // end anonymous namespace
+
+SearchInfo::SearchInfo()
+    : search(0),
+      version(0),
+      depth(0),
+      rating(0.0f),
+      completedDepth(0),
+      nodes(0),
+      seconds(0.0) {
+}
+
+double SearchInfo::nodesPerSecond() const {
+  return this->seconds > 0.0 ? this->nodes / this->seconds : 0.0;
+}
+
+SearchProgress::SearchProgress()
+    : _sequence(0),
+      _search(0),
+      _version(0),
+      _depth(0),
+      _rating(0.0f),
+      _move(packMove(Move())),
+      _completedDepth(0),
+      _completedMove(packMove(Move())),
+      _nodes(0),
+      _seconds(0.0),
+      _start(std::chrono::steady_clock::now()) {
+}
+
+/// forget the results of the previous search (called by the searching thread)
+void SearchProgress::start(uint64_t search) {
+  this->_start = std::chrono::steady_clock::now();
+  this->_sequence.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  this->_search.store(search, std::memory_order_relaxed);
+  this->_version.store(0, std::memory_order_relaxed);
+  this->_depth.store(0, std::memory_order_relaxed);
+  this->_move.store(packMove(Move()), std::memory_order_relaxed);
+  this->_completedDepth.store(0, std::memory_order_relaxed);
+  this->_completedMove.store(packMove(Move()), std::memory_order_relaxed);
+  this->_sequence.fetch_add(1, std::memory_order_release);
+}
+
+/// new best move of the running iteration, or result of a completed iteration
+void SearchProgress::publish(int depth, float rating, Move move, uint64_t nodes, bool completed) {
+  double seconds = std::chrono::duration< double >(std::chrono::steady_clock::now() - this->_start).count();
+  this->_sequence.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  this->_version.store(this->_version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  this->_depth.store(depth, std::memory_order_relaxed);
+  this->_rating.store(rating, std::memory_order_relaxed);
+  this->_move.store(packMove(move), std::memory_order_relaxed);
+  if (completed) {
+    this->_completedDepth.store(depth, std::memory_order_relaxed);
+    this->_completedMove.store(packMove(move), std::memory_order_relaxed);
+  }
+  this->_nodes.store(nodes, std::memory_order_relaxed);
+  this->_seconds.store(seconds, std::memory_order_relaxed);
+  this->_sequence.fetch_add(1, std::memory_order_release);
+}
+
+/// consistent copy of the latest result (from any thread)
+SearchInfo SearchProgress::read() const {
+  SearchInfo info;
+  uint64_t before, after;
+  do {
+    before = this->_sequence.load(std::memory_order_acquire);
+    info.search = this->_search.load(std::memory_order_relaxed);
+    info.version = this->_version.load(std::memory_order_relaxed);
+    info.depth = this->_depth.load(std::memory_order_relaxed);
+    info.rating = this->_rating.load(std::memory_order_relaxed);
+    info.move = unpackMove(this->_move.load(std::memory_order_relaxed));
+    info.completedDepth = this->_completedDepth.load(std::memory_order_relaxed);
+    info.completedMove = unpackMove(this->_completedMove.load(std::memory_order_relaxed));
+    info.nodes = this->_nodes.load(std::memory_order_relaxed);
+    info.seconds = this->_seconds.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    after = this->_sequence.load(std::memory_order_relaxed);
+  } while ((before & 1) != 0 || before != after);
+  return info;
+}
+
+const size_t DifficultyLevel::COUNT;
+
+DifficultyLevel::DifficultyLevel()
+    : nodes(0),
+      seconds(0.0) {
+}
+
+DifficultyLevel::DifficultyLevel(uint64_t nodes, double seconds)
+    : nodes(nodes),
+      seconds(seconds) {
+}
+
+/// difficulty levels for a machine searching the given number of nodes per second
+/**
+ level i (counted from 0) takes about 0.05 * 2^i seconds per move, i.e.
+ from 50 ms up to 6.4 s; its time cap is twice as long, so the node
+ budget decides unless the machine is busy or the position is unusually
+ expensive.
+ */
+std::vector< DifficultyLevel > DifficultyLevel::calibrate(double nodesPerSecond) {
+  std::vector< DifficultyLevel > levels;
+  double seconds = 0.05;
+  for (size_t i = 0; i < COUNT; i++) {
+    uint64_t nodes = static_cast< uint64_t >(std::max(nodesPerSecond * seconds, 1000.0));
+    levels.push_back(DifficultyLevel(nodes, 2 * seconds));
+    seconds *= 2;
+  }
+  return levels;
+}
+
+/// measure search speed of this machine by searching the initial position for the given time
+double DifficultyLevel::measureNodesPerSecond(double seconds) {
+  Game game((GameConfig()));
+  SearchLimits limits;
+  limits.deadline = std::chrono::steady_clock::now()
+      + std::chrono::duration_cast< std::chrono::steady_clock::duration >(std::chrono::duration< double >(seconds));
+  game.setSearchLimits(limits);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int level = 1; level <= 100 && !game.searchAborted(); level++) {
+    game.searchBestMove(level);
+  }
+  double elapsed = std::chrono::duration< double >(std::chrono::steady_clock::now() - start).count();
+  return elapsed > 0.0 ? game.searchStats().nodes / elapsed : 0.0;
+}
+
 bool Evaluation::less::operator()(const Evaluation& lhs, const Evaluation& rhs) const {
   if (lhs.rating < rhs.rating) {
     return true;
@@ -275,9 +550,21 @@ Game::Game(GameConfig c)
     _dice(18, DieState()),
     _mode(c.getPlayMode()),
     _aiDepth(c.getAiDepth()),
+    _aiNodeBudget(c.getAiNodeBudget()),
+    _aiTimeLimit(c.getAiTimeLimit()),
     _strategy(c.getAiStrategy()),
     _nextPlayer(WHITE),
-    _state(IDLE) {
+    _state(IDLE),
+    _hash(0),
+    _nodeBase(0),
+    _rootLevel(0),
+    _aborted(false),
+    _progress(NULL),
+    _hashRotated(0),
+    _book(NULL),
+    _repetitionFilter(REPETITION_FILTER_SIZE, 0),
+    _repetitionDraw(c.getRepetitionDraw()),
+    _randomSeed(0) {
     this->_setup();
 }
 
@@ -288,13 +575,29 @@ Game::Game(const Game& other)
       _dice(other._dice),
       _mode(other._mode),
       _aiDepth(other._aiDepth),
+      _aiNodeBudget(other._aiNodeBudget),
+      _aiTimeLimit(other._aiTimeLimit),
       _strategy(other._strategy),
       _moveStack(other._moveStack),
       _moveStackPending(other._moveStackPending),
       _deathStack(other._deathStack),
       _deathStackPending(other._deathStackPending),
       _nextPlayer(other._nextPlayer),
-      _state(other._state) {
+      _state(other._state),
+      _hash(other._hash),
+      _stats(other._stats),
+      _nodeBase(other._nodeBase),
+      _rootLevel(other._rootLevel),
+      _limits(other._limits),
+      _aborted(other._aborted),
+      _progress(other._progress),
+      _hashRotated(other._hashRotated),
+      _book(other._book),
+      _hashHistory(other._hashHistory),
+      _repetitionFilter(other._repetitionFilter),
+      _repetitionDraw(other._repetitionDraw),
+      _randomSeed(other._randomSeed),
+      _random(other._random) {
 }
 
 Game& Game::operator=(const Game& other) {
@@ -304,6 +607,8 @@ Game& Game::operator=(const Game& other) {
     this->_dice = other._dice;
     this->_mode = other._mode;
     this->_aiDepth = other._aiDepth;
+    this->_aiNodeBudget = other._aiNodeBudget;
+    this->_aiTimeLimit = other._aiTimeLimit;
     this->_strategy = other._strategy;
     this->_moveStack = other._moveStack;
     this->_moveStackPending = other._moveStackPending;
@@ -311,6 +616,20 @@ Game& Game::operator=(const Game& other) {
     this->_deathStackPending = other._deathStackPending;
     this->_nextPlayer = other._nextPlayer;
     this->_state = other._state;
+    this->_hash = other._hash;
+    this->_stats = other._stats;
+    this->_nodeBase = other._nodeBase;
+    this->_rootLevel = other._rootLevel;
+    this->_limits = other._limits;
+    this->_aborted = other._aborted;
+    this->_progress = other._progress;
+    this->_hashRotated = other._hashRotated;
+    this->_book = other._book;
+    this->_hashHistory = other._hashHistory;
+    this->_repetitionFilter = other._repetitionFilter;
+    this->_repetitionDraw = other._repetitionDraw;
+    this->_randomSeed = other._randomSeed;
+    this->_random = other._random;
   }
   return *this;
 }
@@ -349,6 +668,7 @@ void Game::_setup() {
   for (size_t x = 0; x <= 8; x++) {
     this->_fields[x][8] = x + 9;
   }
+  this->_computeHash();
 }
 
 void Game::clearBoard(){
@@ -366,12 +686,17 @@ size_t Game::getNumberOfDice(){
 /// move die over board
 void Game::makeMove(Move move, bool storeMove) {
   //TODO: check correctness! (Game::makeMove)
-  KBX::Logger log("DieState");
+  KBX_ALLOC_SITE("makeMove");
+  if (storeMove) {
+    this->_pushHistory();
+  }
   //// perform move
   DieState& dieState = this->_dice[move.dieIndex];
-  log.info(stringprintf("initial state: %d", dieState.getCurrentState()));
+  KBX_LOG_INFO("DieState", "initial state: %d", (int) dieState.getCurrentState());
   // delete die from current position on board
   this->_fields[dieState.x()][dieState.y()] = CLEAR;
+  this->_hash ^= this->_zobristKey(dieState);
+  this->_hashRotated ^= this->_rotatedZobristKey(dieState);
   // get directions for horizontal movement (aka x coordinate)
   int directionX, directionY;
   if (move.rel.dx < 0) {
@@ -399,16 +724,18 @@ void Game::makeMove(Move move, bool storeMove) {
   for (size_t i = stepsFirst; i > 0; i--) {
     // rotate in first direction
     dieState.moveOneStep(directionFirst);
-    log.info(stringprintf("new state: %d", dieState.getCurrentState()));
+    KBX_LOG_INFO("DieState", "new state: %d", (int) dieState.getCurrentState());
   }
   for (size_t i = stepsSec; i > 0; i--) {
     // rotate in second direction
     dieState.moveOneStep(directionSec);
-    log.info(stringprintf("new state: %d", dieState.getCurrentState()));
+    KBX_LOG_INFO("DieState", "new state: %d", (int) dieState.getCurrentState());
   }
   // delete old die on this position before moving new die to it
   int keyOldDie = this->_fields[dieState.x()][dieState.y()];
   if (keyOldDie != CLEAR) {
+    this->_hash ^= this->_zobristKey(this->_dice[keyOldDie]);
+    this->_hashRotated ^= this->_rotatedZobristKey(this->_dice[keyOldDie]);
     this->_dice[keyOldDie].kill();
   }
   // if the move should be stored, do so
@@ -420,11 +747,25 @@ void Game::makeMove(Move move, bool storeMove) {
   }
   // move die to new position
   this->_fields[dieState.x()][dieState.y()] = move.dieIndex;
+  this->_hash ^= this->_zobristKey(dieState);
+  this->_hashRotated ^= this->_rotatedZobristKey(dieState);
   this->_nextPlayer = inverse(this->_nextPlayer);
+  this->_hash ^= this->_zobristKeys.back();
+  this->_hashRotated ^= this->_zobristKeys.back();
+}
+
+/// perform move without storing it for undo/redo
+/**
+ the position is still remembered for the detection of repetitions.
+ this keeps long series of games (e.g. self-play) from growing the move lists.
+ */
+void Game::playMove(Move move) {
+  this->_pushHistory();
+  this->makeMove(move, false);
 }
 
 Move Game::undoMove() {
-  if(_moveStack.empty()){
+  if(!this->_canUndo()){
     return Move();
   }
   Move backMove = this->_moveStack.front();
@@ -438,22 +779,75 @@ Move Game::undoMove() {
   if(victim != CLEAR){
     this->reviveDie(victim);
   }
+  this->_popHistory();
   return backMove;
 }
 
 Move Game::redoMove() {
   //TODO: untested
-  if(_moveStackPending.empty()) return Move();
+  if(!this->_canRedo()) return Move();
   Move reMove = this->_moveStackPending.front();
   int victim = this->_deathStackPending.front();
   this->_moveStackPending.pop_front();
   this->_deathStackPending.pop_front();
   this->_moveStack.push_front(reMove);
   this->_deathStack.push_front(victim);
+  this->_pushHistory();
   this->makeMove(reMove, false);
   return reMove;
 }
 
+/// check, if the last stored move can be taken back
+/**
+ the die must be on the board and return to a free field, its victim
+ (if any) must be dead and lie on the die's field. the history of a
+ damaged savegame fails here instead of corrupting the board.
+ */
+bool Game::_canUndo() {
+  if (this->_moveStack.empty() || this->_deathStack.empty()) {
+    return false;
+  }
+  Move move = this->_moveStack.front();
+  int victim = this->_deathStack.front();
+  if (move.dieIndex < 0 || move.dieIndex >= (int) this->_dice.size()) {
+    return false;
+  }
+  DieState& die = this->_dice[move.dieIndex];
+  int x = die.x() - move.rel.dx;
+  int y = die.y() - move.rel.dy;
+  if (die.gotKilled() || x < 0 || x > 8 || y < 0 || y > 8 || this->_fields[x][y] != CLEAR) {
+    return false;
+  }
+  if (victim == CLEAR) {
+    return true;
+  }
+  if (victim < 0 || victim >= (int) this->_dice.size()) {
+    return false;
+  }
+  DieState& dead = this->_dice[victim];
+  return (dead.gotKilled() && dead.getFormerState() < DEAD && dead.x() == die.x() && dead.y() == die.y());
+}
+
+/// check, if the last move taken back can be redone
+/**
+ the die must stay on the board and find its victim (or a free field)
+ on the target field.
+ */
+bool Game::_canRedo() {
+  if (this->_moveStackPending.empty() || this->_deathStackPending.empty()) {
+    return false;
+  }
+  Move move = this->_moveStackPending.front();
+  int victim = this->_deathStackPending.front();
+  if (move.dieIndex < 0 || move.dieIndex >= (int) this->_dice.size() || victim == move.dieIndex) {
+    return false;
+  }
+  DieState& die = this->_dice[move.dieIndex];
+  int x = die.x() + move.rel.dx;
+  int y = die.y() + move.rel.dy;
+  return ( !die.gotKilled() && x >= 0 && x <= 8 && y >= 0 && y <= 8 && this->_fields[x][y] == victim);
+}
+
 /// check if a given move is valid
 /**
  \returns true, if the move is valid, else false
@@ -643,8 +1037,18 @@ float Game::_rate(PlayColor color) {
   rating += this->_strategy.coeffDiceRatio * this->_rateDiceRatio(color);
   return rating;
 }
+
+/// return the unweighted ratings of all rating functions for a specified playcolor
+/**
+ the rating of a running game is the sum of these terms,
+ weighted by Strategy::ratingWeights.
+ */
+std::vector< float > Game::ratingTerms(PlayColor color) {
+  return std::vector< float >(1, this->_rateDiceRatio(color));
+}
 /// return list of all possible moves of selected die in current board setting
 std::list< Move > Game::possibleMoves(size_t dieId) {
+  KBX_ALLOC_SITE("possibleMoves");
   std::list< Move > moves;
   int val = this->_dice[dieId].getValue();
   std::vector< RelativeMove >::const_iterator relMv;
@@ -656,17 +1060,294 @@ std::list< Move > Game::possibleMoves(size_t dieId) {
   }
   return moves;
 }
+/// return all valid moves of the player with next move
+std::vector< Move > Game::validMoves() {
+  std::vector< Move > moves;
+  for (size_t d = 0; d < this->_dice.size(); d++) {
+    if (this->_dice[d].getColor() == this->_nextPlayer && !this->_dice[d].gotKilled()) {
+      std::list< Move > dieMoves = this->possibleMoves(d);
+      moves.insert(moves.end(), dieMoves.begin(), dieMoves.end());
+    }
+  }
+  return moves;
+}
+/// use the given opening book for the first moves of a game (NULL disables the book)
+void Game::setOpeningBook(const OpeningBook* book) {
+  this->_book = book;
+}
+
+/// count leaf nodes of the game tree up to the given depth
+/**
+ positions with a winner are leaves, since no moves follow.
+ this walks the same move generation as the search, so the
+ counts verify moveIsValid/makeMove and measure their speed.
+ \param depth depth in plies
+ \returns number of leaf nodes
+ */
+uint64_t Game::perft(int depth) {
+  if (depth == 0 || this->getWinner() != NONE_OF_BOTH) {
+    return 1;
+  }
+  uint64_t nodes = 0;
+  size_t from = (this->_nextPlayer == WHITE) ? 0 : 9;
+  for (size_t d = from; d < from + 9; d++) {
+    size_t value = this->_dice[d].getValue();
+    for (size_t i = 0; i < DieState::nPossibleMoves[value]; i++) {
+      RelativeMove move = DieState::possibleMoves[value][i];
+      if (this->moveIsValid(Move(d, move))) {
+        int idDieOnTarget = this->_fields[this->_dice[d].x() + move.dx][this->_dice[d].y() + move.dy];
+        this->makeMove(Move(d, move), false);
+        nodes += this->perft(depth - 1);
+        this->makeMove(Move(d, move.invert()), false);
+        if (idDieOnTarget != CLEAR) {
+          this->reviveDie(idDieOnTarget);
+        }
+      }
+    }
+  }
+  return nodes;
+}
+
+/// convert move to text notation
+/**
+ the notation gives the fields the die moves from and to
+ (columns a-i, rows 1-9 from white's side), e.g. 'e1e3'.
+ for moves in both directions, an 'x' or 'y' tells which
+ direction the die rolls first, e.g. 'c1d3y'.
+ */
+std::string Game::moveToString(Move move) {
+  if ( !move) {
+    return "none";
+  }
+  DieState& die = this->_dice[move.dieIndex];
+  std::string str;
+  str += (char) ('a' + die.x());
+  str += (char) ('1' + die.y());
+  str += (char) ('a' + die.x() + move.rel.dx);
+  str += (char) ('1' + die.y() + move.rel.dy);
+  if (move.rel.dx != 0 && move.rel.dy != 0) {
+    str += move.rel.firstX ? 'x' : 'y';
+  }
+  return str;
+}
+
+/// parse move from text notation (see moveToString)
+/**
+ \returns parsed move; an invalid move (dieIndex == -1), if the
+          text cannot be parsed or there is no die on the first field
+ */
+Move Game::moveFromString(const std::string& str) {
+  if (str.size() < 4 || str.size() > 5) {
+    return Move();
+  }
+  int x = str[0] - 'a';
+  int y = str[1] - '1';
+  int dx = str[2] - 'a' - x;
+  int dy = str[3] - '1' - y;
+  if (x < 0 || x > 8 || y < 0 || y > 8 || x + dx < 0 || x + dx > 8 || y + dy < 0 || y + dy > 8) {
+    return Move();
+  }
+  int dieId = this->_fields[x][y];
+  if (dieId == CLEAR) {
+    return Move();
+  }
+  // straight moves are always stored like in DieState::possibleMoves
+  bool firstX = (dy == 0);
+  if (dx != 0 && dy != 0) {
+    if (str.size() != 5 || (str[4] != 'x' && str[4] != 'y')) {
+      return Move();
+    }
+    firstX = (str[4] == 'x');
+  }
+  return Move(dieId, RelativeMove(dx, dy, firstX));
+}
+
+/// make the random choices of the following searches reproducible
+/**
+ every search (and book probe) draws from its own random stream, seeded
+ from the given seed and the position only. so a search gives the same
+ nodes and move for the same seed and position, no matter which searches
+ ran before or on how many threads.
+ \param seed 0: seed every search from the clock (default)
+ */
+void Game::setRandomSeed(uint64_t seed) {
+  this->_randomSeed = seed;
+}
+
+uint64_t Game::randomSeed() {
+  return this->_randomSeed;
+}
+
+/// start the random stream of a search (see setRandomSeed)
+void Game::_seedRandom() {
+  if (this->_randomSeed == 0) {
+    this->_random.seed(clockSeed());
+  } else {
+    // std::seed_seq mixes the words well, so neighbouring seeds give unrelated streams
+    std::seed_seq seq = {
+      static_cast< uint32_t >(this->_randomSeed), static_cast< uint32_t >(this->_randomSeed >> 32),
+      static_cast< uint32_t >(this->_hash), static_cast< uint32_t >(this->_hash >> 32)
+    };
+    this->_random.seed(seq);
+  }
+}
+
 /// return next evaluated move
 Move Game::evaluateNext() {
+  KBX_TRACE_SCOPE("evaluateNext", "engine");
+  this->resetSearchStats();
+  // book moves are played directly, without any search
+  if (this->_book) {
+    this->_seedRandom();
+    Move bookMove = this->_book->probe( *this, this->_random);
+    if (bookMove) {
+      return bookMove;
+    }
+  }
   this->_state = EVALUATING;
-  // aiDepth = number of human moves anticipated (hence times two because of response moves)
-  Evaluation eval = this->_evaluateMoves(this->_aiDepth * 2, -100.0f, 100.0f, true);
+  Evaluation eval(0.0f);
+  if (this->_aiNodeBudget > 0 || this->_aiTimeLimit > 0.0) {
+    eval = this->_searchWithinBudget();
+  } else {
+    // aiDepth = number of human moves anticipated (hence times two because of response moves)
+    eval = this->searchBestMove(this->_aiDepth * 2);
+  }
   if (this->evaluating()) {
     this->_state = IDLE;
   }
   return eval.move;
 }
 
+/// iterative deepening until the node budget or the time limit of the computer player is used up
+/**
+ the result of the deepest completed iteration is played. if not even
+ depth 1 fits into the limits, depth 1 is searched anyway, since a move
+ has to be made; it takes only a few hundred nodes.
+ */
+Evaluation Game::_searchWithinBudget() {
+  SearchLimits previous = this->_limits;
+  SearchLimits limits = previous;
+  if (this->_aiNodeBudget > 0) {
+    limits.nodes = this->nodeCount() + this->_aiNodeBudget;
+  }
+  if (this->_aiTimeLimit > 0.0) {
+    limits.deadline = std::chrono::steady_clock::now()
+        + std::chrono::duration_cast< std::chrono::steady_clock::duration >(std::chrono::duration< double >(this->_aiTimeLimit));
+  }
+  this->_limits = limits;
+  Evaluation best(0.0f);
+  // a search cannot get deeper than the game is long
+  for (int level = 1; level <= 100; level++) {
+    Evaluation eval = this->searchBestMove(level);
+    if (this->searchAborted() || this->cancelled()) {
+      break;
+    }
+    best = eval;
+  }
+  this->_limits = previous;
+  if ( !best.move && !this->cancelled()) {
+    best = this->searchBestMove(1);
+  }
+  return best;
+}
+
+/// search best move for the player with next move (without consulting the opening book)
+/**
+ \param level search depth in plies
+ \returns best move and its rating
+ */
+Evaluation Game::searchBestMove(int level) {
+  KBX_TRACE_SCOPE("searchBestMove", "engine");
+  KBX_ALLOC_SITE("searchBestMove");
+  // transient search data is released at once when the search ends
+  SearchArena::Scope arena;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  AllocCounters allocs = AllocTracking::thread();
+  uint64_t nodes = this->_stats.nodes;
+  this->_aborted = false;
+  this->_rootLevel = level;
+  this->_seedRandom();
+  Evaluation eval = this->_evaluateMoves(level, -100.0f, 100.0f, true);
+  if (this->_progress && !this->_aborted && !this->cancelled() && eval.move) {
+    this->_progress->publish(level, eval.rating, eval.move, this->_stats.nodes, true);
+  }
+  IterationStats iteration;
+  iteration.depth = level;
+  iteration.nodes = this->_stats.nodes - nodes;
+  iteration.seconds = std::chrono::duration< double >(std::chrono::steady_clock::now() - start).count();
+  this->_stats.iterations.push_back(iteration);
+  allocs = AllocTracking::thread() - allocs;
+  this->_stats.allocations += allocs.allocations;
+  this->_stats.allocatedBytes += allocs.bytes;
+  return eval;
+}
+
+/// return number of nodes searched since the last reset
+uint64_t Game::nodeCount() {
+  return this->_stats.nodes - this->_nodeBase;
+}
+
+/// start counting nodes anew (the node counts of searchStats go on)
+void Game::resetNodeCount() {
+  this->_nodeBase = this->_stats.nodes;
+}
+
+/// return counters of all searches since the last reset
+const SearchStats& Game::searchStats() {
+  return this->_stats;
+}
+
+void Game::resetSearchStats() {
+  this->_stats.reset();
+  this->_nodeBase = 0;
+}
+
+/// limit node count and time of the following searches
+/**
+ the node limit refers to nodeCount, so it spans all searches up to the
+ next resetNodeCount (e.g. all iterations of an iterative deepening).
+ */
+void Game::setSearchLimits(const SearchLimits& limits) {
+  this->_limits = limits;
+}
+
+/// publish the best root move to progress during every following search (NULL: stop publishing)
+void Game::setSearchProgress(SearchProgress* progress) {
+  this->_progress = progress;
+}
+
+/// true, if the last search was aborted by its limits; its result is meaningless then
+bool Game::searchAborted() {
+  return this->_aborted;
+}
+
+/// check search limits; the clock is only read every 1024 nodes
+bool Game::_limitReached() {
+  if ( !this->_aborted) {
+    this->_aborted = (this->_limits.stop && this->_limits.stop->load(std::memory_order_relaxed))
+        || (this->_limits.nodes > 0 && this->nodeCount() >= this->_limits.nodes)
+        || ((this->_stats.nodes & 1023) == 0 && std::chrono::steady_clock::now() >= this->_limits.deadline);
+  }
+  return this->_aborted;
+}
+
+/// rate the current position for the player with next move
+/**
+ \param level search depth in plies
+ \returns the negamax rating of a full-width search
+ */
+float Game::evaluatePosition(int level) {
+  SearchArena::Scope arena;
+  this->_aborted = false;
+  this->_rootLevel = level;
+  return this->_evaluateMoves(level, -100.0f, 100.0f, false).rating;
+}
+
+/// return static rating of the current position for the given color (no search)
+float Game::rate(PlayColor color) {
+  return this->_rate(color);
+}
+
 /// print an evaluation
 void Game::printEvaluation(const Evaluation& eval){
   DieState& die = this->getDie(eval.move.dieIndex);
@@ -688,14 +1369,28 @@ void Game::printEvaluation(const Evaluation& eval){
 /// evaluate best possible move up to a certain level
 /// this is done recursively by a form of the NegaMax algorithm with alpha-beta pruning
 Evaluation Game::_evaluateMoves(int level, float alpha, float beta, bool initialCall) {
-  KBX::Logger log("evaluation");
+  KBX_ALLOC_SITE("_evaluateMoves");
+  this->_stats.nodes++;
+  // a repeated position is a draw, since the players can repeat the cycle;
+  // this cuts off the whole subtree
+  if ( !initialCall && this->_repetitionDraw > 0) {
+    this->_stats.hashProbes++;
+    if (this->_repetitions() > 0) {
+      this->_stats.hashHits++;
+      return Evaluation(0.0f);
+    }
+  }
   if ((level == 0) || (this->getWinner() != NONE_OF_BOTH)) {
+    this->_stats.leaves++;
+    this->_stats.maxDepth = std::max(this->_stats.maxDepth, this->_rootLevel - level);
     return Evaluation(this->_rate(this->_nextPlayer));
   }
+  // number of valid moves searched so far
+  size_t nSearched = 0;
   // get rating, either directly or by recursive call
   float rating;
-  // container for best move candidates
-  std::priority_queue< Evaluation, std::vector< Evaluation >, Evaluation::less > candidates;
+  // container for best move candidates (in the search arena, see searchBestMove)
+  std::priority_queue< Evaluation, std::vector< Evaluation, ArenaAllocator< Evaluation > >, Evaluation::less > candidates;
   // limit indices to significant color
   size_t from, to;
   if (this->_nextPlayer == WHITE) {
@@ -712,7 +1407,7 @@ Evaluation Game::_evaluateMoves(int level, float alpha, float beta, bool initial
     // iterate over max number of moves for given dice value (stored in state-array)
     for (size_t i = 0; i < DieState::nPossibleMoves[value]; i++) {
       // abort evaluation if cancelled
-      if (this->cancelled()) {
+      if (this->cancelled() || this->_limitReached()) {
         return Evaluation(0.0f);
       }
       // check if this specific move is valid
@@ -723,6 +1418,7 @@ Evaluation Game::_evaluateMoves(int level, float alpha, float beta, bool initial
         // kill the die lying on the target field
         int idDieOnTarget = this->_fields[this->_dice[d].x() + move.dx][this->_dice[d].y() + move.dy];
         // perform move
+        this->_pushHistory();
         this->makeMove(Move(d, move), false);
         // recursive call for next step (negative weighting, since it is opponent's turn)
         rating = - this->_strategy.patience * this->_evaluateMoves(level - 1, -beta, -alpha, false).rating;
@@ -732,8 +1428,11 @@ Evaluation Game::_evaluateMoves(int level, float alpha, float beta, bool initial
         if (idDieOnTarget != CLEAR) {
           this->reviveDie(idDieOnTarget);
         }
+        this->_popHistory();
+        nSearched++;
         // alpha-beta pruning
         if (rating >= beta) {
+          this->_stats.cutoffsByMove[std::min(nSearched, SearchStats::CUTOFF_SLOTS) - 1]++;
           return Evaluation(rating);
         }
         if (rating > alpha) {
@@ -741,6 +1440,10 @@ Evaluation Game::_evaluateMoves(int level, float alpha, float beta, bool initial
           if (initialCall == true) {
             // add move to candidate list
             candidates.push(Evaluation(rating, Move(d, move)));
+            // the rating of an aborted subtree is meaningless
+            if (this->_progress && !this->_aborted && !this->cancelled()) {
+              this->_progress->publish(level, rating, Move(d, move), this->_stats.nodes, false);
+            }
           }
         }
       }
@@ -749,16 +1452,18 @@ Evaluation Game::_evaluateMoves(int level, float alpha, float beta, bool initial
   if (initialCall == true) {
     if ( ! candidates.empty()) {
       float topRating = candidates.top().rating;
-      std::vector<Evaluation> topCandidates;
-      log.info(stringprintf("top rating: %0.4f", topRating));
-      while ((candidates.top().rating >= topRating) && ( ! candidates.empty())) {
+      std::vector< Evaluation, ArenaAllocator< Evaluation > > topCandidates;
+      KBX_LOG_INFO("evaluation", "top rating: %0.4f", topRating);
+      while (( ! candidates.empty()) && (candidates.top().rating >= topRating)) {
         topCandidates.push_back(candidates.top());
         candidates.pop();
       }
-      log.info(stringprintf("next rating: %0.4f", candidates.top().rating));
-      log.info(stringprintf("no. of top candidates: %d", topCandidates.size()));
+      if ( ! candidates.empty()) {
+        KBX_LOG_INFO("evaluation", "next rating: %0.4f", candidates.top().rating);
+      }
+      KBX_LOG_INFO("evaluation", "no. of top candidates: %d", (int) topCandidates.size());
       // randomly select from equally rated top candidates
-      std::size_t iTop = randomIndex(0, topCandidates.size()-1);
+      std::size_t iTop = randomIndex(0, topCandidates.size()-1, this->_random);
       return topCandidates[iTop];
     }
   }
@@ -768,6 +1473,88 @@ Evaluation Game::_evaluateMoves(int level, float alpha, float beta, bool initial
 void Game::reviveDie(size_t idDieOnTarget){
   this->_dice[idDieOnTarget].revive();
   this->_fields[this->_dice[idDieOnTarget].x()][this->_dice[idDieOnTarget].y()] = idDieOnTarget;
+  this->_hash ^= this->_zobristKey(this->_dice[idDieOnTarget]);
+  this->_hashRotated ^= this->_rotatedZobristKey(this->_dice[idDieOnTarget]);
+}
+
+/// zobrist keys: one per color, field and die state, plus one for black to move
+const std::vector< uint64_t > Game::_zobristKeys = initZobristKeys();
+/// generate zobrist keys
+/**
+ the keys are generated by a fixed splitmix64 sequence. they must never change,
+ since opening books store positions by their hash.
+ */
+const std::vector< uint64_t > Game::initZobristKeys() {
+  std::vector< uint64_t > keys(2 * 81 * 26 + 1);
+  uint64_t seed = 0x4b75626978ULL;
+  for (size_t i = 0; i < keys.size(); i++) {
+    seed += 0x9e3779b97f4a7c15ULL;
+    uint64_t z = seed;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    keys[i] = z ^ (z >> 31);
+  }
+  return keys;
+}
+
+/// return zobrist key of a die (zero for killed dice)
+uint64_t Game::_zobristKey(DieState& die) {
+  if (die.gotKilled()) {
+    return 0;
+  }
+  size_t color = (die.getColor() == WHITE) ? 0 : 1;
+  return this->_zobristKeys[((color * 9 + die.x()) * 9 + die.y()) * 26 + die.getCurrentState()];
+}
+
+/// return zobrist key of a die on the rotated board (with swapped colors)
+uint64_t Game::_rotatedZobristKey(DieState& die) {
+  if (die.gotKilled()) {
+    return 0;
+  }
+  size_t color = (die.getColor() == WHITE) ? 1 : 0;
+  size_t state = DieState::rotatedStates[die.getCurrentState()];
+  return this->_zobristKeys[((color * 9 + 8 - die.x()) * 9 + 8 - die.y()) * 26 + state];
+}
+
+/// recalculate position hashes from scratch
+void Game::_computeHash() {
+  this->_hash = 0;
+  this->_hashRotated = 0;
+  for (size_t i = 0; i < this->_dice.size(); i++) {
+    this->_hash ^= this->_zobristKey(this->_dice[i]);
+    this->_hashRotated ^= this->_rotatedZobristKey(this->_dice[i]);
+  }
+  // on the rotated board, the other color moves next
+  if (this->_nextPlayer == BLACK) {
+    this->_hash ^= this->_zobristKeys.back();
+  } else {
+    this->_hashRotated ^= this->_zobristKeys.back();
+  }
+}
+
+/// return hash of current position (dice on board and player with next move)
+uint64_t Game::hash() {
+  return this->_hash;
+}
+
+/// return hash of the canonical form of the current position
+/**
+ a position and its image after rotating the board by 180 degrees
+ and swapping colors are equivalent (from the view of the player
+ with next move). the canonical form is the one with the smaller hash,
+ so both are stored only once in the opening book.
+ */
+uint64_t Game::canonicalHash() {
+  return std::min(this->_hash, this->_hashRotated);
+}
+
+/// check, if the current position is its own canonical form
+/**
+ \returns true, if the position is canonical; else moves and fields
+          must be rotated to match the canonical form
+ */
+bool Game::isCanonical() {
+  return (this->_hash <= this->_hashRotated);
 }
 
 /// reset the game
@@ -780,6 +1567,8 @@ void Game::reset() {
     this->_moveStackPending.pop_front();
     this->_deathStackPending.pop_front();
   }
+  this->_hashHistory.clear();
+  std::fill(this->_repetitionFilter.begin(), this->_repetitionFilter.end(), 0);
   this->_setup();
 }
 
@@ -819,6 +1608,101 @@ void Game::setAiDepth(size_t aiDepth) {
   this->_aiDepth = aiDepth;
 }
 
+uint64_t Game::aiNodeBudget() {
+  return this->_aiNodeBudget;
+}
+
+/// search every computer move with the given number of nodes instead of aiDepth (0: use aiDepth)
+void Game::setAiNodeBudget(uint64_t nodes) {
+  this->_aiNodeBudget = nodes;
+}
+
+double Game::aiTimeLimit() {
+  return this->_aiTimeLimit;
+}
+
+/// abort the search of a computer move after the given time in seconds (0: no limit)
+void Game::setAiTimeLimit(double seconds) {
+  this->_aiTimeLimit = seconds;
+}
+
+size_t Game::repetitionDraw() {
+  return this->_repetitionDraw;
+}
+
+void Game::setRepetitionDraw(size_t repetitions) {
+  this->_repetitionDraw = repetitions;
+}
+
+/// check, if the game is drawn by repetition of the current position
+/**
+ \returns true, if the current position has occurred as often as given
+          by the draw rule (including the current occurrence)
+ */
+bool Game::isDraw() {
+  return (this->_repetitionDraw > 0 && this->_repetitions() + 1 >= this->_repetitionDraw);
+}
+
+/// remember current position before making a move
+void Game::_pushHistory() {
+  KBX_ALLOC_SITE("history");
+  this->_hashHistory.push_back(this->_hash);
+  this->_repetitionFilter[this->_hash & (REPETITION_FILTER_SIZE - 1)]++;
+}
+
+/// forget last remembered position after taking back a move
+void Game::_popHistory() {
+  if (this->_hashHistory.empty()) {
+    return;
+  }
+  this->_repetitionFilter[this->_hashHistory.back() & (REPETITION_FILTER_SIZE - 1)]--;
+  this->_hashHistory.pop_back();
+}
+
+/// recalculate position history from the stored moves (e.g. after loading a game)
+/**
+ \returns false, if not all stored moves can be taken back and redone
+          (the history stays empty then)
+ */
+bool Game::_rebuildHistory() {
+  this->_hashHistory.clear();
+  std::fill(this->_repetitionFilter.begin(), this->_repetitionFilter.end(), 0);
+  std::vector< uint64_t > hashes;
+  Game replay( *this);
+  while (replay.undoMove()) {
+    hashes.push_back(replay.hash());
+  }
+  if ( !replay._moveStack.empty() || !replay._deathStack.empty()) {
+    return false;
+  }
+  while (replay.redoMove()) {
+  }
+  if ( !replay._moveStackPending.empty() || !replay._deathStackPending.empty()) {
+    return false;
+  }
+  for (std::vector< uint64_t >::reverse_iterator h = hashes.rbegin(); h != hashes.rend(); h++) {
+    this->_hashHistory.push_back( *h);
+    this->_repetitionFilter[ *h & (REPETITION_FILTER_SIZE - 1)]++;
+  }
+  return true;
+}
+
+/// count earlier occurrences of the current position in game and search history
+size_t Game::_repetitions() {
+  // most positions are ruled out without looking at the history
+  if (this->_repetitionFilter[this->_hash & (REPETITION_FILTER_SIZE - 1)] == 0) {
+    return 0;
+  }
+  size_t n = 0;
+  // only every second position has the same player with next move
+  for (size_t i = this->_hashHistory.size(); i >= 2; i -= 2) {
+    if (this->_hashHistory[i - 2] == this->_hash) {
+      n++;
+    }
+  }
+  return n;
+}
+
 /// rate dice ratio
 /**
  rate according to the ratio of the number of dice on the board
@@ -19,15 +19,22 @@
 #define ENGINE__HPP
 
 #include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <string>
 #include <vector>
 #include <list>
+#include <random>
 
 #include "global.hpp"
-#include "config.hpp"
+#include "game_config.hpp"
 
 namespace KBX {
 
+class OpeningBook;
+
 class RelativeMove {
   public:
     int dx;
@@ -36,6 +43,7 @@ class RelativeMove {
     RelativeMove();
     RelativeMove(int dx, int dy, bool FIRST_X);
     RelativeMove invert();
+    RelativeMove rotate();
     bool operator==(const RelativeMove& other);
     friend std::ostream& operator<< (std::ostream &out, const RelativeMove& move);
     friend std::istream& operator>> (std::istream &stream, RelativeMove& move);
@@ -60,6 +68,9 @@ class DieState {
     // list of possible (relative) moves for a die
     static const std::vector< std::vector< RelativeMove > > possibleMoves;
     static const std::vector< std::vector< RelativeMove > > initPossibleMoves();
+    // die states after rotating the board by 180 degrees
+    static const std::vector< size_t > rotatedStates;
+    static const std::vector< size_t > initRotatedStates();
 
     DieState();
     DieState(int x, int y, PlayColor color, size_t state);
@@ -99,6 +110,126 @@ class Evaluation {
     };
 };
 
+/// duration and size of a single call of Game::searchBestMove
+class IterationStats {
+  public:
+    int depth;
+    uint64_t nodes;
+    double seconds;
+};
+
+/// work done by the searches of a game (see Game::searchStats)
+/**
+ every game counts for itself, so searches running on different
+ threads never share counters; merge sums up the counters of several
+ games once their searches are done.
+ */
+class SearchStats {
+  public:
+    // beta cutoffs are counted by index of the refuting move, the last slot takes all later ones
+    static const size_t CUTOFF_SLOTS = 8;
+    SearchStats();
+    void reset();
+    void merge(const SearchStats& other);
+    uint64_t cutoffs() const;
+    double seconds() const;
+    double nodesPerSecond() const;
+    std::string summary() const;
+    uint64_t nodes;
+    // nodes rated statically (depth exhausted or game won)
+    uint64_t leaves;
+    std::vector< uint64_t > cutoffsByMove;
+    // lookups of the position hash in the repetition history, and repetitions found
+    uint64_t hashProbes;
+    uint64_t hashHits;
+    // maximum distance from the root in plies
+    int maxDepth;
+    // heap allocations during the searches (see AllocTracking)
+    uint64_t allocations;
+    uint64_t allocatedBytes;
+    std::vector< IterationStats > iterations;
+};
+
+/// limits of a search; once one is exceeded, the search is aborted (see Game::searchAborted)
+class SearchLimits {
+  public:
+    SearchLimits();
+    // maximum node count (see Game::nodeCount), 0: unlimited
+    uint64_t nodes;
+    std::chrono::steady_clock::time_point deadline;
+    // set from any thread to stop the search (NULL: never)
+    const std::atomic< bool >* stop;
+};
+
+/// intermediate result of a running search (see SearchProgress)
+class SearchInfo {
+  public:
+    SearchInfo();
+    // id of the search, as given to SearchProgress::start
+    uint64_t search;
+    // number of results published for this search (0: none yet)
+    uint64_t version;
+    // depth of the iteration in plies; rating and move are the best of it so far
+    int depth;
+    float rating;
+    Move move;
+    // best move of the deepest completed iteration (invalid before depth 1 is done);
+    // the first root moves of an iteration are best only for lack of others
+    int completedDepth;
+    Move completedMove;
+    uint64_t nodes;
+    double seconds;
+    double nodesPerSecond() const;
+};
+
+/// latest result of a search, written by the searching thread and read by any thread without locks
+/**
+ a sequence lock: the searching thread makes the sequence number odd
+ while it writes, readers retry until they read the same even number
+ before and after copying. readers never hold up the search, which
+ publishes whenever the best root move changes and after every
+ completed iteration (see Game::setSearchProgress).
+ */
+class SearchProgress {
+  public:
+    SearchProgress();
+    void start(uint64_t search);
+    void publish(int depth, float rating, Move move, uint64_t nodes, bool completed);
+    SearchInfo read() const;
+  private:
+    std::atomic< uint64_t > _sequence;
+    std::atomic< uint64_t > _search;
+    std::atomic< uint64_t > _version;
+    std::atomic< int > _depth;
+    std::atomic< float > _rating;
+    // moves packed into 32 bit (see packMove in engine.cpp)
+    std::atomic< uint32_t > _move;
+    std::atomic< int > _completedDepth;
+    std::atomic< uint32_t > _completedMove;
+    std::atomic< uint64_t > _nodes;
+    std::atomic< double > _seconds;
+    // only used by the searching thread
+    std::chrono::steady_clock::time_point _start;
+};
+
+/// difficulty of the computer player: node budget and time cap of a move
+/**
+ the node budget decides the strength, and so the played move does not
+ depend on the speed of the machine; the time cap guarantees an upper
+ bound of the response time on slow machines (or in slow positions).
+ levels are calibrated once per host by measuring the search speed.
+ */
+class DifficultyLevel {
+  public:
+    static const size_t COUNT = 8;
+    DifficultyLevel();
+    DifficultyLevel(uint64_t nodes, double seconds);
+    uint64_t nodes;
+    double seconds;
+    static std::vector< DifficultyLevel > calibrate(double nodesPerSecond);
+    static double measureNodesPerSecond(double seconds);
+};
+
 class Game {
   public:
     Game(const Game& other);
@@ -111,9 +242,15 @@ class Game {
 
     bool moveIsValid(Move move);
     void makeMove(Move move, bool storeMove);
+    void playMove(Move move);
     Move undoMove();
     Move redoMove();
     std::list< Move > possibleMoves(size_t dieId);
+    std::vector< Move > validMoves();
+    uint64_t perft(int depth);
+
+    std::string moveToString(Move move);
+    Move moveFromString(const std::string& str);
 
     void clearBoard();
 
@@ -137,6 +274,15 @@ class Game {
     size_t aiDepth();
     void setAiDepth(size_t aiDepth);
 
+    uint64_t aiNodeBudget();
+    void setAiNodeBudget(uint64_t nodes);
+    double aiTimeLimit();
+    void setAiTimeLimit(double seconds);
+
+    size_t repetitionDraw();
+    void setRepetitionDraw(size_t repetitions);
+    bool isDraw();
+
     size_t getNumberOfDice();
     DieState& getDie(size_t id);
     DieState& getDie(size_t x, size_t y);
@@ -149,13 +295,47 @@ class Game {
     void printEvaluation(const Evaluation& eval);
     Strategy& getStrategy();
 
+    uint64_t hash();
+    uint64_t canonicalHash();
+    bool isCanonical();
+
+    void setOpeningBook(const OpeningBook* book);
+    void setRandomSeed(uint64_t seed);
+    uint64_t randomSeed();
     Move evaluateNext();
+    Evaluation searchBestMove(int level);
+    float evaluatePosition(int level);
+    float rate(PlayColor color);
+    std::vector< float > ratingTerms(PlayColor color);
+    uint64_t nodeCount();
+    void resetNodeCount();
+    const SearchStats& searchStats();
+    void resetSearchStats();
+    void setSearchLimits(const SearchLimits& limits);
+    bool searchAborted();
+    void setSearchProgress(SearchProgress* progress);
 
   private:
     enum State {
       CANCELLED, EVALUATING, IDLE, FINISHED
     };
     Evaluation _evaluateMoves(int level, float alpha, float beta, bool initialCall);
+    Evaluation _searchWithinBudget();
+    bool _limitReached();
+    void _seedRandom();
+    // zobrist keys for every (color, field, die state) and the side to move
+    static const std::vector< uint64_t > _zobristKeys;
+    static const std::vector< uint64_t > initZobristKeys();
+    uint64_t _zobristKey(DieState& die);
+    uint64_t _rotatedZobristKey(DieState& die);
+    void _computeHash();
+    // repetition detection
+    void _pushHistory();
+    void _popHistory();
+    bool _rebuildHistory();
+    bool _canUndo();
+    bool _canRedo();
+    size_t _repetitions();
     // rating functions
     float _rateDiceRatio(PlayColor color);
     float _rate(PlayColor color);
@@ -163,6 +343,9 @@ class Game {
     std::vector< DieState > _dice; // [18]
     PlayMode _mode;
     size_t _aiDepth;
+    // limits of a computer move; if set, they replace the fixed search depth
+    uint64_t _aiNodeBudget;
+    double _aiTimeLimit;
     Strategy _strategy;
     std::list< Move > _moveStack;
     std::list< Move > _moveStackPending;
@@ -170,6 +353,30 @@ class Game {
     std::list< int > _deathStackPending;
     PlayColor _nextPlayer;
     State _state;
+    uint64_t _hash;
+    // counters of the searches since the last reset
+    SearchStats _stats;
+    // _stats.nodes at the last resetNodeCount, nodeCount counts from there
+    uint64_t _nodeBase;
+    // search depth of the running search, to tell the distance from the root
+    int _rootLevel;
+    SearchLimits _limits;
+    // set once a search limit is exceeded, until the next search
+    bool _aborted;
+    // receives the best root move during the search (NULL: none)
+    SearchProgress* _progress;
+    // hash of the board rotated by 180 degrees with colors swapped
+    uint64_t _hashRotated;
+    const OpeningBook* _book;
+    // hashes of all positions before the current one (game and search path)
+    std::vector< uint64_t > _hashHistory;
+    // number of history entries per hash bucket, to rule out repetitions in O(1)
+    std::vector< uint16_t > _repetitionFilter;
+    // number of occurrences of a position that make the game a draw (0: never)
+    size_t _repetitionDraw;
+    // random choices (book moves, equally rated moves) of the running search, see setRandomSeed
+    uint64_t _randomSeed;
+    std::mt19937_64 _random;
     void _setup();
 };
 
@@ -0,0 +1,108 @@
+/*  
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "game_config.hpp"
+
+
+void GameConfig::setAiDepth(size_t aiDepth){
+  this->_aiDepth = aiDepth;
+}
+
+size_t GameConfig::getAiDepth() const {
+  return this->_aiDepth;
+}
+
+void GameConfig::setAiNodeBudget(uint64_t nodes){
+  this->_aiNodeBudget = nodes;
+}
+
+uint64_t GameConfig::getAiNodeBudget() const {
+  return this->_aiNodeBudget;
+}
+
+void GameConfig::setAiTimeLimit(double seconds){
+  this->_aiTimeLimit = seconds;
+}
+
+double GameConfig::getAiTimeLimit() const {
+  return this->_aiTimeLimit;
+}
+
+void GameConfig::setRepetitionDraw(size_t repetitions){
+  this->_repetitionDraw = repetitions;
+}
+
+size_t GameConfig::getRepetitionDraw() const {
+  return this->_repetitionDraw;
+}
+
+KBX::PlayMode GameConfig::getPlayMode() const {
+  return this->_playMode;
+}
+
+void GameConfig::setPlayMode(KBX::PlayMode mode){
+  this->_playMode = mode;
+}
+
+void GameConfig::setAiStrategy(KBX::Strategy s){
+  this->_aiStrategy = s;
+}
+
+KBX::Strategy GameConfig::getAiStrategy() const {
+  return this->_aiStrategy;
+}
+
+void GameConfig::setAllowUndoRedo(bool allow){
+  this->_allowUndoRedo = allow;
+}
+
+bool GameConfig::getAllowUndoRedo() const {
+  return this->_allowUndoRedo;
+}
+
+GameConfig::GameConfig(const GameConfig& other) :
+  _aiDepth(other.getAiDepth()),
+  _aiNodeBudget(other.getAiNodeBudget()),
+  _aiTimeLimit(other.getAiTimeLimit()),
+  _repetitionDraw(other.getRepetitionDraw()),
+  _allowUndoRedo(other.getAllowUndoRedo()),
+  _aiStrategy(other.getAiStrategy()),
+  _playMode(other.getPlayMode())
+{
+}
+
+GameConfig::GameConfig(const GameConfig* other) :
+  _aiDepth(other ? other->getAiDepth() : 1),
+  _aiNodeBudget(other ? other->getAiNodeBudget() : 0),
+  _aiTimeLimit(other ? other->getAiTimeLimit() : 0.0),
+  _repetitionDraw(other ? other->getRepetitionDraw() : 3),
+  _allowUndoRedo(other ? other->getAllowUndoRedo() : true),
+  _aiStrategy(other ? other->getAiStrategy() : KBX::Strategy()),
+  _playMode(other ? other->getPlayMode() : KBX::HUMAN_AI)
+{
+}
+
+GameConfig::GameConfig() :
+  _aiDepth(1),
+  _aiNodeBudget(0),
+  _aiTimeLimit(0.0),
+  _repetitionDraw(3),
+  _allowUndoRedo(true),
+  _aiStrategy(),
+  _playMode(KBX::HUMAN_AI)
+{
+}
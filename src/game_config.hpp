@@ -0,0 +1,65 @@
+/*  
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KBX_GAME_CONFIG__HPP
+#define KBX_GAME_CONFIG__HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "global.hpp"
+
+class GameConfig {
+  protected:
+    size_t _aiDepth;
+    // limits of a computer move (0: search aiDepth moves ahead instead)
+    uint64_t _aiNodeBudget;
+    double _aiTimeLimit;
+    size_t _repetitionDraw;
+    bool _allowUndoRedo;
+    KBX::Strategy _aiStrategy;
+    KBX::PlayMode _playMode;
+
+  public:
+    GameConfig();
+    GameConfig(const GameConfig& other);
+    GameConfig(const GameConfig* other);
+
+    virtual void setAllowUndoRedo(bool allow);
+    virtual bool getAllowUndoRedo() const;
+
+    virtual void setAiStrategy(KBX::Strategy s);
+    virtual KBX::Strategy getAiStrategy() const;
+
+    virtual void setAiDepth(size_t aiDepth);
+    virtual size_t getAiDepth() const;
+
+    virtual void setAiNodeBudget(uint64_t nodes);
+    virtual uint64_t getAiNodeBudget() const;
+
+    virtual void setAiTimeLimit(double seconds);
+    virtual double getAiTimeLimit() const;
+
+    virtual void setRepetitionDraw(size_t repetitions);
+    virtual size_t getRepetitionDraw() const;
+    
+    virtual void setPlayMode(KBX::PlayMode mode);
+    virtual KBX::PlayMode getPlayMode() const;
+
+};
+
+#endif
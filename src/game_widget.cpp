@@ -3,6 +3,8 @@
 #include "models.hpp"
 #include "config.hpp"
 #include "main_window.hpp"
+#include "trace.hpp"
+#include "alloc.hpp"
 
 #include <GL/glu.h>
 #include <QtGui>
@@ -13,9 +15,17 @@
 #include <fstream>
 #include <sstream>
 #include <thread>
+#include <chrono>
+#include <algorithm>
 
 namespace KBX {
 
+// time limit and maximum depth in plies of the move hints
+const double HINT_SECONDS = 2.0;
+const int HINT_MAX_DEPTH = 8;
+// rating loss shown as red
+const float HINT_SCALE = 2.0f;
+
 //TODO: add menu items / preferences for
 //      autoRefresh and relativeMarking
 
@@ -31,6 +41,10 @@ void GameWidget::newGame(GameConfig c) {
   delete this->_game;
   this->_allowUndoRedo = c.getAllowUndoRedo();
   this->_game = new Game(c);
+  this->_game->setRandomSeed(this->_randomSeed);
+  if (this->_book.isOpen()) {
+    this->_game->setOpeningBook( &this->_book);
+  }
   // setup board and make change known to renderer
   this->_scene->setup();
   this->changed();
@@ -50,16 +64,69 @@ GameWidget::GameWidget(QWidget *parent)
       _bfChange(0),
       _relativeMarking(false),
       _log("act"),
-      _evaluationFinished(false){
+      _searchRequest(0),
+      _evaluationFinished(false),
+      _shownProgress(0),
+      _moveHints(false),
+      _hintRequest(0),
+      _aiGames(0),
+      _aiWhiteWins(0),
+      _aiBlackWins(0),
+      _autosave(true),
+      _randomSeed(0),
+      _engineQueue(enginePool().addQueue()),
+      _hintSearch(enginePool(), _engineQueue),
+      _engine(enginePool(), _engineQueue) {
+  qRegisterMetaType< KBX::Move >();
+  qRegisterMetaType< KBX::SearchStats >();
+  connect(this, SIGNAL(engineMoveFound(quint64, KBX::Move, KBX::SearchStats)),
+          this, SLOT(searchFinished(quint64, KBX::Move, KBX::SearchStats)), Qt::QueuedConnection);
+  qRegisterMetaType< KBX::MoveHint >();
+  connect(this, SIGNAL(moveHintFound(quint64, KBX::MoveHint)),
+          this, SLOT(hintScored(quint64, KBX::MoveHint)), Qt::QueuedConnection);
   setMouseTracking(false);
   setFocusPolicy(Qt::StrongFocus);
   // initialize game with some stupid defaults in case there is no config
   Config c(this);
   this->_game = new Game(c);
+  Die::setAnimationSpeed(c.value("game/animationSpeed", 1).toInt());
+  // the opening book is optional; without it, every move is searched
+  std::string bookFile = c.value("engine/openingBook", "kubix.book").toString().toStdString();
+  if (fileExists(bookFile) && this->_book.open(bookFile)) {
+    this->_game->setOpeningBook( &this->_book);
+  }
+}
+
+GameWidget::~GameWidget() {
+  // searches and hints run on copies of the game, they are stopped with the members
+  delete this->_scene;
+  delete this->_game;
+}
+
+/// threads for the searches and move hints of all games
+/**
+ every game widget has its own queue in the pool (see ThreadPool::addQueue),
+ so the games are served in turn, however many jobs each one submits.
+ all game widgets must be destroyed before the pool (i.e. before main returns).
+ */
+ThreadPool& GameWidget::enginePool() {
+  static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+  return pool;
 }
 
 void GameWidget::cancelEvaluation() {
-  this->_game->cancelEvaluation();
+  // late results of the cancelled search are ignored by their request id
+  this->_engine.cancel();
+  this->_searchRequest = 0;
+  this->_evaluationFinished = false;
+  this->_clearBestMove();
+}
+
+/// stop the engine search and play the best move found so far
+void GameWidget::moveNow() {
+  if (this->_searchRequest != 0 && !this->_evaluationFinished) {
+    this->_engine.finish();
+  }
 }
 
 void GameWidget::togglePause(){
@@ -87,6 +154,8 @@ void GameWidget::undoLastMove(){
     return;
   }
   this->setPausedState(true);
+  // hints of the old position must neither stay nor arrive later
+  this->_clearDieSelection();
   int victim = this->_game->getLastMovesVictim();
   Move m = this->_game->undoMove();
   if(m){
@@ -106,6 +175,7 @@ void GameWidget::undoLastMove(){
 void GameWidget::redoLastMove(){
   if(!this->_allowUndoRedo) return;
   this->cancelEvaluation();
+  this->_clearDieSelection();
   Move m = this->_game->redoMove();
   int victim = this->_game->getLastMovesVictim();
   if(m){
@@ -172,6 +242,11 @@ void GameWidget::_clearDieSelection() {
   }
   this->_paths.clear();
   this->_selectedDie = NULL;
+  // the hints belong to the paths and the position; scores of the
+  // cancelled request are ignored by its id (see hintScored)
+  this->_hintSearch.cancel();
+  this->_hintRequest = 0;
+  this->_hintScores.clear();
 }
 
 /// enable/disable automatic updating of the scene
@@ -206,6 +281,44 @@ void GameWidget::setAutoRefresh(bool newAutoRefresh) {
   this->changed();
 }
 
+/// draw the moves of the selected die (or of all dice, if none is selected) colored by their score
+void GameWidget::setMoveHints(bool show) {
+  this->_moveHints = show;
+  this->_clearDieSelection();
+  this->changed();
+}
+
+bool GameWidget::moveHints() {
+  return this->_moveHints;
+}
+
+/// save the game to .autosave.kbx after every move (on by default; with several games, only one should)
+void GameWidget::setAutosave(bool autosave) {
+  this->_autosave = autosave;
+}
+
+/// reproducible engine moves (see Game::setRandomSeed), also for all following games
+void GameWidget::setRandomSeed(uint64_t seed) {
+  this->_randomSeed = seed;
+  this->_game->setRandomSeed(seed);
+}
+
+/// use this opening book instead of the one in the settings (e.g. given on the command line)
+void GameWidget::setOpeningBook(const std::string& bookFile) {
+  // searches probing the old book must end before it is unmapped
+  this->cancelEvaluation();
+  this->_hintSearch.cancel();
+  this->_hintSearch.wait();
+  while (this->_engine.busy()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  this->_game->setOpeningBook(NULL);
+  this->_book.close();
+  if (fileExists(bookFile) && this->_book.open(bookFile)) {
+    this->_game->setOpeningBook( &this->_book);
+  }
+}
+
 void GameWidget::setRelativeMarking(bool newRelativeMarking) {
   this->_relativeMarking = newRelativeMarking;
 }
@@ -223,15 +336,27 @@ void GameWidget::resizeGL(int w, int h) {
 }
 
 void GameWidget::paintGL() {
+  KBX_TRACE_SCOPE("GameWidget::paintGL", "render");
+  KBX_ALLOC_SITE("GameWidget::paintGL");
   if (this->_needUpdate()) {
+    AllocCounters allocs = AllocTracking::thread();
     this->setBackgroundColor();
     // if you want to debug the color-picking, use the this->scene->display_picking() instead
     this->_scene->display();
     // set update flag to redraw scene
     this->_updated();
+    this->_frameAllocs = AllocTracking::thread() - allocs;
+    KBX_LOG_DEBUG("alloc", "frame: %llu allocations, %llu bytes",
+                  static_cast< unsigned long long >(this->_frameAllocs.allocations),
+                  static_cast< unsigned long long >(this->_frameAllocs.bytes));
   }
 }
 
+/// heap allocations of the last rendered frame (see AllocTracking)
+AllocCounters GameWidget::frameAllocations() {
+  return this->_frameAllocs;
+}
+
 /// handle a new mouse press event
 /**
  \param event incoming event
@@ -363,7 +488,8 @@ void GameWidget::keyPressEvent(QKeyEvent* event) {
 void GameWidget::userSelect(Model* obj) {
   //FIXME: this function is currently only working with mouse interaction
   KBX::Logger log("userSelect");
-  if ( !this->_game->finished()) {
+  // no input while the engine is to move; its best move so far is shown as a path, too
+  if ( !this->_game->finished() && !this->_engineMoves()) {
     // dynamically select clicked object
     Die* die = dynamic_cast< Die* >(obj);
     Tile* tile = dynamic_cast< Tile* >(obj);
@@ -383,6 +509,9 @@ void GameWidget::userSelect(Model* obj) {
           this->_paths.push_back(this->_scene->add(new Path(this->_scene, die->getPosition(), *mv)));
         }
         this->_selectedDie = die;
+        if (this->_moveHints) {
+          this->_startHints(std::vector< Move >(moves.begin(), moves.end()));
+        }
       } else {
         if (this->_selectedDie) {
           // die of other player: get tile below die and treat with 'tile-code' below
@@ -472,9 +601,19 @@ void GameWidget::load(std::string ifname){
     }
     //TODO use log instead of cout
     std::cout << "loading game from " << ifname << std::endl;
-    infile >> (*this->_game);
-    this->_scene->setupFromGame(this->_game);
+    // read into a copy, so a broken file leaves the current game alone
+    Game loaded( *this->_game);
+    infile >> loaded;
     infile.close();
+    if (infile.fail()) {
+      this->_log.warning("Error: cannot read savegame...");
+      return;
+    }
+    this->cancelEvaluation();
+    // the scene is set up anew, paths included
+    this->_clearDieSelection();
+    *this->_game = loaded;
+    this->_scene->setupFromGame(this->_game);
   }
 }
 
@@ -488,17 +627,16 @@ void GameWidget::_performMove(Move m) {
   if(this->_game->finished()) {
     return;
   }
-  QMessageBox msgBox;
   if (m == Move()) {
     // empty move: 'next player' loses
     PlayColor next = this->_game->getNext();
-    if (next == this->_game->getAiColor()) {
-      msgBox.setText("computer gives up. you win.");
+    if (this->_game->playMode() == AI_AI) {
+      this->_gameOver(next == WHITE ? "white gives up." : "black gives up.", inverse(next));
+    } else if (next == this->_game->getAiColor()) {
+      this->_gameOver("computer gives up. you win.", inverse(next));
     } else {
-      msgBox.setText("you give up. loser!");
+      this->_gameOver("you give up. loser!", inverse(next));
     }
-    msgBox.exec();
-    this->_game->setFinished();
   } else {
     int dieId = m.dieIndex;
     int oldX = this->_game->getDie(dieId).x();
@@ -518,24 +656,78 @@ void GameWidget::_performMove(Move m) {
     PlayColor winner = this->_game->getWinner();
     if (winner != NONE_OF_BOTH) {
       if (winner == this->_game->getAiColor()) {
-        msgBox.setText("computer wins.");
+        this->_gameOver("computer wins.", winner);
       } else if (winner == this->_game->getHumanColor()) {
-        msgBox.setText("you win.");
+        this->_gameOver("you win.", winner);
       } else if (winner == WHITE) {
-        msgBox.setText("white wins.");
+        this->_gameOver("white wins.", winner);
       } else {
-        msgBox.setText("black wins.");
+        this->_gameOver("black wins.", winner);
       }
-      msgBox.exec();
-      this->_game->setFinished();
-    } else {
+    } else if (this->_game->isDraw()) {
+      this->_gameOver("draw by repetition.", NONE_OF_BOTH);
+    } else if (this->_autosave && this->_game->playMode() != AI_AI) {
+      // engine games would overwrite the autosave of the last human game
       this->save(".autosave.kbx");
     }
   }
 }
 
+/// finish the game; engine games are only counted, since the next one starts by itself
+void GameWidget::_gameOver(const QString& text, PlayColor winner) {
+  this->_game->setFinished();
+  if (this->_game->playMode() == AI_AI) {
+    this->_aiGames++;
+    if (winner == WHITE) {
+      this->_aiWhiteWins++;
+    } else if (winner == BLACK) {
+      this->_aiBlackWins++;
+    }
+    emit this->newStatus(QString("AI vs. AI: %1 (games: %2, white wins: %3, black wins: %4, draws: %5)")
+                         .arg(text)
+                         .arg(this->_aiGames)
+                         .arg(this->_aiWhiteWins)
+                         .arg(this->_aiBlackWins)
+                         .arg(this->_aiGames - this->_aiWhiteWins - this->_aiBlackWins));
+  } else {
+    QMessageBox msgBox;
+    msgBox.setText(text);
+    msgBox.exec();
+  }
+}
+
+/// start the next engine game with the settings of the last one, once its last move is shown
+void GameWidget::_nextEngineGame() {
+  if (this->_scene->movingDie() != KBX::NONE && this->_scene->getDie(this->_scene->movingDie())->isMoving()) {
+    return;
+  }
+  GameConfig c;
+  c.setPlayMode(this->_game->playMode());
+  c.setAiDepth(this->_game->aiDepth());
+  c.setAiNodeBudget(this->_game->aiNodeBudget());
+  c.setAiTimeLimit(this->_game->aiTimeLimit());
+  c.setRepetitionDraw(this->_game->repetitionDraw());
+  c.setAiStrategy(this->_game->getStrategy());
+  c.setAllowUndoRedo(this->_allowUndoRedo);
+  this->_scene->setMovingDie(KBX::NONE);
+  this->newGame(c);
+}
+
+/// cycle the animation speed: normal, 2x, 4x, 8x, no animations
+void GameWidget::cycleAnimationSpeed() {
+  int speed = Die::animationSpeed();
+  speed = (speed == 0) ? 1 : (speed >= 8 ? 0 : 2 * speed);
+  Die::setAnimationSpeed(speed);
+  Config(this).setValue("game/animationSpeed", speed);
+  if (speed == 0) {
+    emit this->newStatus("animations off");
+  } else {
+    emit this->newStatus(QString("animation speed: %1x").arg(speed));
+  }
+}
+
 void GameWidget::performEvaluatedMove(){
-  if( ! this->paused() && ! this->_game->cancelled()){
+  if( ! this->paused()){
     // if the game is paused, we do not accept engine input
     this->_performMove(this->_moveToPerform);
   }
@@ -544,24 +736,28 @@ void GameWidget::performEvaluatedMove(){
 void GameWidget::update() {
   //TODO: rewrite this function to fully support all play modes, game states, etc
   if ( ! this->_game->finished() && ! this->paused()) {
-    // TODO: quit extra thread when window closes
+    // the engine starts searching while the last move is still shown (the game already knows it);
+    // its move is shown once the animation is done
+    if (this->_engineMoves() && this->_searchRequest == 0) {
+      this->_startSearch();
+    }
     if (this->_scene->movingDie() == KBX::NONE) {
-      if (this->_engineMoves() && !this->_game->evaluating()) {
+      if (this->_engineMoves()) {
         if ( this->_evaluationFinished ){
           this->performEvaluatedMove();
           this->setEngineFinished();
         } else {
-          // encapsulate move evaluation by engine
-          // in separate thread to keep UI reactive
-          this->setEngineRunning();
-          std::thread engineThread(&GameWidget::_startEvaluationThread, this); 
-          engineThread.detach();
+          this->_showProgress();
         }
-      } 
+      } else if (this->_moveHints && this->_hintRequest == 0 && !this->_selectedDie && this->_paths.empty()) {
+        this->_showAllHints();
+      }
     } else if ( !this->_scene->getDie(this->_scene->movingDie())->isMoving()) {
       // release lock after die has finished moving
       this->_scene->setMovingDie(KBX::NONE);
     }
+  } else if (this->_game->finished() && this->_game->playMode() == AI_AI && ! this->paused()) {
+    this->_nextEngineGame();
   }
   QGLWidget::update();
 }
@@ -576,6 +772,8 @@ bool GameWidget::_engineMoves() {
     if (this->_game->getNext() == WHITE) {
       engineMoves = true;
     }
+  } else if (this->_game->playMode() == AI_AI) {
+    engineMoves = true;
   }
   return engineMoves;
 }
@@ -586,12 +784,133 @@ void GameWidget::setEngineRunning() {
 
 void GameWidget::setEngineFinished() {
   this->_evaluationFinished = false;
-  emit this->newStatus("Kubix is waiting for your move.");
+  this->_searchRequest = 0;
+  this->_clearBestMove();
+  if (this->_game->playMode() == AI_AI) {
+    // nobody waits; the status shows the next search or the result of the game
+    return;
+  }
+  if (this->_lastSearch.nodes > 0) {
+    emit this->newStatus(QString::fromStdString("Kubix is waiting for your move. (last search: " + this->_lastSearch.summary() + ")"));
+  } else {
+    emit this->newStatus("Kubix is waiting for your move.");
+  }
+}
+
+/// search the engine move on a copy of the game, to keep the UI reactive
+void GameWidget::_startSearch() {
+  this->setEngineRunning();
+  this->_searchRequest = this->_engine.submit( *this->_game, [this](uint64_t request, Move move, const SearchStats& stats) {
+    emit this->engineMoveFound(request, move, stats);
+  });
+}
+
+/// show depth, score, speed and best move of the running search, if they have changed
+void GameWidget::_showProgress() {
+  SearchInfo info = this->_engine.progress();
+  if (info.search != this->_searchRequest || info.version == this->_shownProgress) {
+    return;
+  }
+  this->_shownProgress = info.version;
+  emit this->newStatus(QString("Kubix is computing next move: depth %1, score %2, %3 knodes/s, best %4")
+                       .arg(info.depth)
+                       .arg(info.rating, 0, 'f', 2)
+                       .arg(info.nodesPerSecond() / 1000.0, 0, 'f', 0)
+                       .arg(QString::fromStdString(this->_game->moveToString(info.move))));
+  // the move that moveNow would play
+  Move best = info.completedMove ? info.completedMove : info.move;
+  for (std::list< size_t >::iterator it = this->_bestMovePath.begin(); it != this->_bestMovePath.end(); it++) {
+    this->_scene->remove( *it);
+  }
+  this->_bestMovePath.clear();
+  this->_bestMovePath.push_back(this->_scene->add(new Path(this->_scene, this->_scene->getDie(best.dieIndex)->getPosition(), best, Path::BEST_MOVE_COLOR)));
+  this->changed();
+}
+
+void GameWidget::_clearBestMove() {
+  for (std::list< size_t >::iterator it = this->_bestMovePath.begin(); it != this->_bestMovePath.end(); it++) {
+    this->_scene->remove( *it);
+  }
+  this->_bestMovePath.clear();
+  this->_shownProgress = 0;
+}
+
+/// score the given moves in parallel, the paths are colored as the scores arrive
+void GameWidget::_startHints(const std::vector< Move >& moves) {
+  this->_hintScores.clear();
+  this->_hintRequest = this->_hintSearch.start( *this->_game, moves, HINT_SECONDS, HINT_MAX_DEPTH,
+                                               [this](uint64_t request, const MoveHint& hint) {
+    emit this->moveHintFound(request, hint);
+  });
 }
 
-void GameWidget::_startEvaluationThread() {
-  this->_moveToPerform = this->_game->evaluateNext();
+/// draw and score the moves of all dice of the human player
+void GameWidget::_showAllHints() {
+  std::vector< Move > moves = this->_game->validMoves();
+  for (size_t i = 0; i < moves.size(); i++) {
+    Die* die = this->_scene->getDie(moves[i].dieIndex);
+    this->_paths.push_back(this->_scene->add(new Path(this->_scene, die->getPosition(), moves[i])));
+  }
+  if ( !moves.empty()) {
+    this->_startHints(moves);
+  }
+  this->changed();
+}
+
+void GameWidget::hintScored(quint64 request, KBX::MoveHint hint) {
+  if (request != this->_hintRequest) {
+    return;
+  }
+  // keep the deepest score of every move
+  for (size_t i = 0; i < this->_hintScores.size(); i++) {
+    if (this->_hintScores[i].move == hint.move) {
+      if (hint.depth > this->_hintScores[i].depth) {
+        this->_hintScores[i] = hint;
+      }
+      this->_colorHints();
+      return;
+    }
+  }
+  this->_hintScores.push_back(hint);
+  this->_colorHints();
+}
+
+/// green: best move of its search depth, red: loses HINT_SCALE or more
+void GameWidget::_colorHints() {
+  for (std::list< size_t >::iterator it = this->_paths.begin(); it != this->_paths.end(); it++) {
+    Path* path = dynamic_cast< Path* >(this->_scene->get( *it));
+    if ( !path) {
+      continue;
+    }
+    Move move = path->getMove();
+    for (size_t i = 0; i < this->_hintScores.size(); i++) {
+      if ( !(this->_hintScores[i].move == move)) {
+        continue;
+      }
+      // scores are only comparable within a depth
+      float best = this->_hintScores[i].score;
+      for (size_t j = 0; j < this->_hintScores.size(); j++) {
+        if (this->_hintScores[j].depth == this->_hintScores[i].depth) {
+          best = std::max(best, this->_hintScores[j].score);
+        }
+      }
+      float t = std::min(1.0f, (best - this->_hintScores[i].score) / HINT_SCALE);
+      path->setColor(Color(t, 1.0f - t, 0.0f));
+    }
+  }
+  this->changed();
+}
+
+/// result of the engine thread, the move is performed once no die is moving anymore
+void GameWidget::searchFinished(quint64 request, KBX::Move move, KBX::SearchStats stats) {
+  if (request != this->_searchRequest) {
+    // the game has changed since
+    return;
+  }
+  this->_moveToPerform = move;
+  this->_lastSearch = stats;
   this->_evaluationFinished = true;
+  this->update();
 }
 
 } // end namespace KBX
@@ -25,13 +25,18 @@
 #include <list>
 
 #include "models.hpp"
+#include "book.hpp"
 #include "config.hpp"
+#include "alloc.hpp"
+#include "search_service.hpp"
+#include "thread_pool.hpp"
+#include "hints.hpp"
 
-namespace KBX {
+Q_DECLARE_METATYPE(KBX::Move)
+Q_DECLARE_METATYPE(KBX::SearchStats)
+Q_DECLARE_METATYPE(KBX::MoveHint)
 
-// use this function to run as worker
-// to evaluate moves in separate thread
-Move evaluatorFunc(Game game);
+namespace KBX {
 
 
 class GameWidget: public QGLWidget {
@@ -41,6 +46,8 @@ class GameWidget: public QGLWidget {
 
   public:
     GameWidget(QWidget *parent = NULL);
+    ~GameWidget();
+    static ThreadPool& enginePool();
 
     Color bgColor;
     void changed();
@@ -49,10 +56,16 @@ class GameWidget: public QGLWidget {
     void setBackgroundColor();
     void setPausedState(bool paused);
     bool paused();
+    bool moveHints();
+    void setAutosave(bool autosave);
+    void setRandomSeed(uint64_t seed);
+    void setOpeningBook(const std::string& bookFile);
+    AllocCounters frameAllocations();
 
   public slots:
     void setAutoRefresh(bool newAutoRefresh);
     void setRelativeMarking(bool newRelativeMarking);
+    void setMoveHints(bool show);
 
     void newGame(GameConfig c);
     void save();
@@ -63,7 +76,11 @@ class GameWidget: public QGLWidget {
     void togglePause();
     void setEngineRunning();
     void setEngineFinished();
+    void searchFinished(quint64 request, KBX::Move move, KBX::SearchStats stats);
+    void hintScored(quint64 request, KBX::MoveHint hint);
     void performEvaluatedMove();
+    void moveNow();
+    void cycleAnimationSpeed();
     void giveUp();
     void cancelEvaluation();
 
@@ -72,6 +89,10 @@ class GameWidget: public QGLWidget {
 
   signals:
     void newStatus(QString msg);
+    // emitted on the engine thread, delivered queued to searchFinished
+    void engineMoveFound(quint64 request, KBX::Move move, KBX::SearchStats stats);
+    // emitted on pool threads, delivered queued to hintScored
+    void moveHintFound(quint64 request, KBX::MoveHint hint);
 
   protected:
     void initializeGL();
@@ -85,6 +106,7 @@ class GameWidget: public QGLWidget {
   private:
     Scene* _scene;
     Game* _game;
+    OpeningBook _book;
     Die* _selectedDie;
     QPoint _mousePos;
     QTimer* _updateTimer;
@@ -106,10 +128,40 @@ class GameWidget: public QGLWidget {
     void _performMove(Move m);
     bool _relativeMarking;
     Logger _log;
+    // engine state, only touched on the GUI thread
+    // (_searchRequest: id of the awaited search, 0: none)
+    uint64_t _searchRequest;
     Move _moveToPerform;
     bool _evaluationFinished;
+    SearchStats _lastSearch;
+    // intermediate result of the search on display (see SearchService::progress)
+    uint64_t _shownProgress;
+    std::list< size_t > _bestMovePath;
+    AllocCounters _frameAllocs;
     bool _engineMoves();
-    void _startEvaluationThread();
+    void _startSearch();
+    void _showProgress();
+    void _clearBestMove();
+    // scores of the moves drawn as paths (see setMoveHints)
+    bool _moveHints;
+    uint64_t _hintRequest;
+    std::vector< MoveHint > _hintScores;
+    // results of AI_AI games since the start
+    size_t _aiGames;
+    size_t _aiWhiteWins;
+    size_t _aiBlackWins;
+    void _gameOver(const QString& text, PlayColor winner);
+    void _nextEngineGame();
+    void _startHints(const std::vector< Move >& moves);
+    void _showAllHints();
+    void _colorHints();
+    bool _autosave;
+    uint64_t _randomSeed;
+    // queue of this game in the engine pool, so all games get their turn
+    size_t _engineQueue;
+    // declared last, so searches are stopped before anything else is destroyed
+    HintSearch _hintSearch;
+    SearchService _engine;
 };
 
 } // end namespace KBX
@@ -0,0 +1,109 @@
+/*  
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GEOMETRY__HPP
+#define GEOMETRY__HPP
+
+#include <stddef.h>
+#include <ostream>
+#include <math.h>
+
+// vectors and colors of the 3d scene; the math needs neither Qt nor OpenGL
+// (only the members converting from QColor or calling OpenGL do, see tools.cpp)
+
+class QColor;
+
+namespace KBX {
+
+/// defines a simple vector in 3d-cartesian coordinates
+class Vec {
+  public:
+    float x;
+    float y;
+    float z;
+    Vec();
+    Vec(const Vec& other);
+    Vec(float x, float y);
+    Vec(float x, float y, float z);
+    float norm() const;
+    Vec normalized() const;
+    Vec scaled(float a) const;
+    Vec operator*(float a) const;
+    Vec add(Vec v) const;
+    Vec operator+(Vec v) const;
+    Vec sub(Vec v) const;
+    Vec operator-(Vec v) const;
+    bool equals(Vec v);
+    bool operator==(Vec v);
+    Vec rotate(Vec rotAxis, float angle) const;
+    Vec rotate(Vec xAxis, Vec yAxis, Vec zAxis) const;
+    Vec cross(Vec v) const;
+    float dot(const Vec& v) const;
+    float operator*(const Vec& v) const;
+    Vec round() const;
+    void setAsGlVertex3f();
+};
+
+std::ostream& operator<<(std::ostream& out, const Vec&);
+
+
+namespace NormalVectors {
+const Vec Null = Vec(0.0f, 0.0f, 0.0f);
+const Vec X = Vec(1.0f, 0.0f, 0.0f);
+const Vec Y = Vec(0.0f, 1.0f, 0.0f);
+const Vec Z = Vec(0.0f, 0.0f, 1.0f);
+}
+
+/// defines a color
+class Color {
+  public:
+    float r;
+    float g;
+    float b;
+    Color();
+    Color(size_t id);
+    Color(unsigned char r, unsigned char g, unsigned char b);
+    Color(int r, int g, int b);
+    Color(float r, float g, float b);
+    Color(const QColor& qcolor);
+    void setTo(const QColor& qcolor);
+    size_t id() const;
+    void setAsGlColor() const;
+
+    Color& operator = (const QColor& qcolor);
+};
+
+namespace ColorTable {
+const Color BLACK(0.0f, 0.0f, 0.0f);
+const Color WHITE(1.0f, 1.0f, 1.0f);
+const Color GREY10(0.1f, 0.1f, 0.1f);
+const Color GREY20(0.2f, 0.2f, 0.2f);
+const Color GREY30(0.3f, 0.3f, 0.3f);
+const Color GREY40(0.4f, 0.4f, 0.4f);
+const Color GREY50(0.5f, 0.5f, 0.5f);
+const Color GREY60(0.6f, 0.6f, 0.6f);
+const Color GREY70(0.7f, 0.7f, 0.7f);
+const Color GREY80(0.8f, 0.8f, 0.8f);
+const Color GREY90(0.9f, 0.9f, 0.9f);
+const Color RED(1.0f, 0.0f, 0.0f);
+const Color GREEN(0.0f, 1.0f, 0.0f);
+const Color BLUE(0.0f, 0.0f, 1.0f);
+const Color YELLOW(1.0f, 1.0f, 0.0f);
+}
+
+} // end namespace KBX
+#endif
@@ -1,6 +1,9 @@
 #ifndef GLOBAL__HPP
 #define GLOBAL__HPP
 
+#include <string>
+#include <vector>
+
 namespace KBX {
 
 const static int NONE = -1;
@@ -27,6 +30,8 @@ enum PlayMode {
   HUMAN_AI = 0,
   AI_HUMAN = 1,
   HUMAN_HUMAN = 2,
+  // engine plays both colors (e.g. as soak test)
+  AI_AI = 3,
 };
 
 const static char separator = ',';
@@ -55,6 +60,8 @@ class Strategy {
     Strategy();
     Strategy(const Strategy& other);
     void print() const;
+    std::vector< double > ratingWeights() const;
+    void setRatingWeights(const std::vector< double >& weights);
     friend std::ostream& operator<< (std::ostream &out, const Strategy& s);
     friend std::istream& operator>> (std::istream &out, Strategy& s);
 };
@@ -0,0 +1,177 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <chrono>
+
+#include "hints.hpp"
+#include "trace.hpp"
+
+namespace KBX {
+
+MoveHint::MoveHint()
+    : score(0.0f),
+      depth(0) {
+}
+
+MoveHint::MoveHint(Move move, float score, int depth)
+    : move(move),
+      score(score),
+      depth(depth) {
+}
+
+class HintSearch::Request {
+  public:
+    Request(uint64_t id, const Game& game, const std::vector< Move >& moves, const Callback& scored)
+        : id(id),
+          game(game),
+          moves(moves),
+          scored(scored),
+          next(0),
+          stop(false) {
+    }
+    uint64_t id;
+    Game game;
+    std::vector< Move > moves;
+    Callback scored;
+    int maxDepth;
+    std::chrono::steady_clock::time_point deadline;
+    // next search: pass (depth - 1) = next / moves.size(), move = next % moves.size()
+    std::atomic< size_t > next;
+    std::atomic< bool > stop;
+};
+
+HintSearch::Jobs::Jobs(ThreadPool& pool, size_t queue)
+    : pool(pool),
+      queue(queue),
+      queued(0),
+      running(0) {
+}
+
+/**
+ \param pool threads to search on, must outlive the object
+ \param queue pool queue of the jobs (see ThreadPool::addQueue)
+ */
+HintSearch::HintSearch(ThreadPool& pool, size_t queue)
+    : _lastId(0),
+      _jobs(new Jobs(pool, queue)) {
+}
+
+/// cancel and wait for the running searches; queued jobs return without searching
+HintSearch::~HintSearch() {
+  this->cancel();
+  std::unique_lock< std::mutex > lock(this->_jobs->mutex);
+  this->_jobs->finished.wait(lock, [this]() {
+    return this->_jobs->running == 0;
+  });
+}
+
+/// score the given moves of a copy of the game; a running request is cancelled
+/**
+ \param seconds time limit of the whole request
+ \param maxDepth maximum search depth in plies
+ \returns id of the request, as passed to the callback (never 0)
+ */
+uint64_t HintSearch::start(const Game& game, const std::vector< Move >& moves, double seconds, int maxDepth,
+                           const Callback& scored) {
+  std::shared_ptr< Request > request;
+  std::shared_ptr< Jobs > jobs = this->_jobs;
+  size_t nJobs;
+  {
+    std::lock_guard< std::mutex > lock(jobs->mutex);
+    if (this->_request) {
+      this->_request->stop = true;
+    }
+    request.reset(new Request(++this->_lastId, game, moves, scored));
+    request->maxDepth = maxDepth;
+    request->deadline = std::chrono::steady_clock::now()
+        + std::chrono::duration_cast< std::chrono::steady_clock::duration >(std::chrono::duration< double >(seconds));
+    this->_request = request;
+    // one chain of jobs per thread, each job hands on to the next one
+    nJobs = std::min(jobs->pool.size(), moves.size());
+    jobs->queued += nJobs;
+  }
+  for (size_t j = 0; j < nJobs; j++) {
+    jobs->pool.submit(jobs->queue, [jobs, request]() {
+      HintSearch::_run(jobs, request);
+    });
+  }
+  return request->id;
+}
+
+/// stop the running request (does not block)
+void HintSearch::cancel() {
+  std::lock_guard< std::mutex > lock(this->_jobs->mutex);
+  if (this->_request) {
+    this->_request->stop = true;
+    this->_request.reset();
+  }
+}
+
+/// block until all searches of this object have ended
+void HintSearch::wait() {
+  std::unique_lock< std::mutex > lock(this->_jobs->mutex);
+  this->_jobs->finished.wait(lock, [this]() {
+    return this->_jobs->queued == 0;
+  });
+}
+
+void HintSearch::_run(std::shared_ptr< Jobs > jobs, std::shared_ptr< Request > request) {
+  {
+    std::lock_guard< std::mutex > lock(jobs->mutex);
+    if (request->stop) {
+      // cancelled (or the object is gone) before the job started
+      jobs->queued--;
+      jobs->finished.notify_all();
+      return;
+    }
+    jobs->running++;
+  }
+  KBX_TRACE_SCOPE("HintSearch", "engine");
+  // search the next move of the request, one ply deeper per pass over all moves
+  size_t i = request->next++;
+  int depth = static_cast< int >(i / request->moves.size()) + 1;
+  bool more = false;
+  if ( !request->stop && depth <= request->maxDepth && std::chrono::steady_clock::now() < request->deadline) {
+    SearchLimits limits;
+    limits.deadline = request->deadline;
+    limits.stop = &request->stop;
+    Game game(request->game);
+    game.setSearchLimits(limits);
+    Move move = request->moves[i % request->moves.size()];
+    game.playMove(move);
+    // rated from the opponent's view one ply shorter, like the moves of a search
+    float score = - game.getStrategy().patience * game.evaluatePosition(depth - 1);
+    if ( !game.searchAborted() && !request->stop) {
+      request->scored(request->id, MoveHint(move, score, depth));
+      more = true;
+    }
+  }
+  std::lock_guard< std::mutex > lock(jobs->mutex);
+  jobs->running--;
+  if (more) {
+    // the chain goes on behind the jobs already waiting in the pool
+    jobs->pool.submit(jobs->queue, [jobs, request]() {
+      HintSearch::_run(jobs, request);
+    });
+  } else {
+    jobs->queued--;
+  }
+  jobs->finished.notify_all();
+}
+
+} // end namespace KBX
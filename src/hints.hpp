@@ -0,0 +1,84 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef HINTS__HPP
+#define HINTS__HPP
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "engine.hpp"
+#include "thread_pool.hpp"
+
+namespace KBX {
+
+/// rating of a candidate move, for the player to move
+class MoveHint {
+  public:
+    MoveHint();
+    MoveHint(Move move, float score, int depth);
+    Move move;
+    float score;
+    // search depth in plies, including the move itself
+    int depth;
+};
+
+/// scores candidate moves of a position on a thread pool, within a time limit
+/**
+ all moves are searched one ply deeper per pass, so the scores of a pass
+ are comparable with each other; every score is passed to the callback
+ (on a pool thread) as soon as it is known. searches still running at the
+ deadline are dropped, as are all of a cancelled request. every pool job
+ scores a single move and then submits its successor to the given pool
+ queue, so the queues of other games get their turn in between.
+ */
+class HintSearch {
+  public:
+    typedef std::function< void(uint64_t request, const MoveHint& hint) > Callback;
+    HintSearch(ThreadPool& pool, size_t queue = 0);
+    ~HintSearch();
+    uint64_t start(const Game& game, const std::vector< Move >& moves, double seconds, int maxDepth, const Callback& scored);
+    void cancel();
+    void wait();
+
+  private:
+    class Request;
+    // shared with the pool jobs, which may start after the object is gone
+    class Jobs {
+      public:
+        Jobs(ThreadPool& pool, size_t queue);
+        ThreadPool& pool;
+        size_t queue;
+        // number of chains of pool jobs of this object (queued or running) and of running jobs
+        size_t queued;
+        size_t running;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    static void _run(std::shared_ptr< Jobs > jobs, std::shared_ptr< Request > request);
+    std::shared_ptr< Request > _request;
+    uint64_t _lastId;
+    std::shared_ptr< Jobs > _jobs;
+};
+
+} // end namespace KBX
+#endif
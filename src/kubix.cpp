@@ -16,13 +16,19 @@
  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <string>
+#include <vector>
+#include <algorithm>
+#include <thread>
 #include <stdlib.h>
-#include <time.h>
 
 #include <QApplication>
 
 #include "tools.hpp"
+#include "config.hpp"
 #include "main_window.hpp"
+#include "analysis.hpp"
+#include "trace.hpp"
+#include "alloc.hpp"
 
 class App: public QApplication {
   public:
@@ -53,6 +59,8 @@ int main(int argc, char** argv) {
   //KBX::Logger::enableWarnings();
   //KBX::Logger::enableErrors();
   //KBX::Logger::enableDebug();
+  // write log lines on a background thread (lines are dropped if the queue of 4096 is full)
+  //KBX::Logger::enableAsync(4096);
 //  KBX::Logger::filter("DieState");
 //  KBX::Logger::filter("evaluation");
 
@@ -60,6 +68,15 @@ int main(int argc, char** argv) {
   bool quit = false;
   std::string loadgame = "";
   std::string randomseed = "";
+  std::string openingbook = "";
+  // batch analysis: --analyze DIR|FILE ... (no window is opened)
+  std::vector< std::string > analyze;
+  bool analyzing = false;
+  std::string report = "analysis.tsv";
+  std::string analysisdepth = "4";
+  std::string threads = "";
+  std::string tracefile = "";
+  bool calibrate = false;
   std::string* val = NULL;
   for(int i=1; i<argc; i++){
     std::string arg(argv[i]);
@@ -68,6 +85,11 @@ int main(int argc, char** argv) {
       val = NULL;
       continue;
     }
+    if(analyzing && arg.compare(0, 1, "-") != 0){
+      analyze.push_back(arg);
+      continue;
+    }
+    analyzing = false;
     if(arg == "-q") {
       quit = true;
     }
@@ -77,25 +99,78 @@ int main(int argc, char** argv) {
     if(arg== "--random-seed"){
       val = &randomseed;
     }
+    if(arg == "--opening-book"){
+      val = &openingbook;
+    }
+    if(arg == "--analyze"){
+      analyzing = true;
+    }
+    if(arg == "--report"){
+      val = &report;
+    }
+    if(arg == "--analysis-depth"){
+      val = &analysisdepth;
+    }
+    if(arg == "--threads"){
+      val = &threads;
+    }
+    if(arg == "--trace"){
+      val = &tracefile;
+    }
+    if(arg == "--calibrate"){
+      calibrate = true;
+    }
+  }
+
+  if(tracefile.size() > 0){
+    // Chrome trace events, written on exit
+    KBX::Trace::start(tracefile);
+  }
+
+  if(analyze.size() > 0){
+    // annotate every move of the games with score, best move and error
+    std::vector< std::string > files = KBX::collectSavegames(analyze);
+    size_t nThreads = threads.size() > 0 ? atoi(threads.c_str()) : std::thread::hardware_concurrency();
+    int depth = std::max(1, atoi(analysisdepth.c_str()));
+    uint64_t seed = strtoull(randomseed.c_str(), NULL, 10);
+    bool ok = KBX::analyzeGames(files, report, depth, nThreads, seed);
+    KBX::Trace::stop();
+    return ok ? 0 : 1;
   }
   
   try {
     QApplication::setAttribute(Qt::AA_X11InitThreads);
     App app(argc, argv);
+    // difficulty levels are node budgets, measured once for this machine
+    Config config;
+    if(calibrate || !config.difficultyCalibrated()){
+      config.calibrateDifficulty();
+    }
     MainWindow *window = new MainWindow();
+    // the engine's choice between equally rated moves is reproducible with a seed
+    window->setRandomSeed(strtoull(randomseed.c_str(), NULL, 10));
+    if(openingbook.size() > 0){
+      // for this session only, the settings keep their book
+      window->setOpeningBook(openingbook);
+    }
     window->show();
     if(loadgame.size() > 0){
       window->loadGameFromFile(loadgame);
     } else if(KBX::fileExists(".autosave.kbx")){
       window->loadGameFromFile(".autosave.kbx");
     }
-    if(randomseed.size() > 0){
-      srand(atoi(randomseed.c_str()));
-    } else {
-      srand(time(NULL));
+    if(quit) {
+      KBX::Trace::stop();
+      return 0;
+    }
+    int result = app.exec();
+    // stops the searches of all games before the engine pool goes away
+    delete window;
+    KBX::Trace::stop();
+    if(KBX::AllocTracking::available()){
+      std::cerr << "heap allocations by site:" << std::endl << KBX::AllocTracking::report();
     }
-    if(quit) return 0;
-    return app.exec();
+    return result;
   } catch (const char* errMsg) {
     KBX::Logger("main").error(std::string(errMsg));
     return 1;
@@ -0,0 +1,214 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// micro-benchmarks of engine and math hot paths.
+//
+// runs headless (no Qt application, no OpenGL context) and prints one
+// tab-separated line per benchmark:
+//   <name> <iterations> <ns per op> <ops per second>
+// the format is meant to be stable, so results can be compared across commits.
+
+#include <stdlib.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+
+#include "engine.hpp"
+#include "util.hpp"
+#include "geometry.hpp"
+
+namespace {
+
+typedef std::chrono::high_resolution_clock Clock;
+
+// results are accumulated here, so the compiler cannot drop the work
+volatile double sink = 0.0;
+
+/// a single benchmark: body performs one operation per call
+struct Benchmark {
+  std::string name;
+  std::function< void() > body;
+};
+
+/// run benchmark body until minTime has passed, return nanoseconds per call
+double measure(const Benchmark& bench, double minTime, uint64_t& iterations) {
+  // warm up caches and branch predictors
+  bench.body();
+  iterations = 0;
+  uint64_t batch = 1;
+  double elapsed = 0.0;
+  while (elapsed < minTime) {
+    Clock::time_point start = Clock::now();
+    for (uint64_t i = 0; i < batch; i++) {
+      bench.body();
+    }
+    elapsed += std::chrono::duration< double >(Clock::now() - start).count();
+    iterations += batch;
+    batch *= 2;
+  }
+  return 1e9 * elapsed / iterations;
+}
+
+void usage() {
+  std::cerr << "usage: kubix_bench [--filter TEXT] [--min-time SECONDS] [--depth N] [--load-game FILE]" << std::endl
+            << "  --filter     run only benchmarks whose name contains TEXT" << std::endl
+            << "  --min-time   minimal run time per benchmark (default 0.5)" << std::endl
+            << "  --depth      search depth in plies for the search benchmark (default 4)" << std::endl
+            << "  --load-game  benchmark a saved position instead of the initial setup" << std::endl;
+}
+
+} // end anonymous namespace
+
+int main(int argc, char** argv) {
+  std::string filter = "";
+  double minTime = 0.5;
+  int depth = 4;
+  std::string loadgame = "";
+  for (int i = 1; i < argc; i++) {
+    std::string arg(argv[i]);
+    if (i + 1 >= argc) {
+      usage();
+      return 1;
+    }
+    std::string val(argv[++i]);
+    if (arg == "--filter") {
+      filter = val;
+    } else if (arg == "--min-time") {
+      minTime = atof(val.c_str());
+    } else if (arg == "--depth") {
+      depth = atoi(val.c_str());
+    } else if (arg == "--load-game") {
+      loadgame = val;
+    } else {
+      usage();
+      return 1;
+    }
+  }
+
+  KBX::Game game((GameConfig()));
+  if (loadgame.size() > 0) {
+    std::ifstream infile(loadgame);
+    if ( !infile.is_open()) {
+      std::cerr << "cannot open '" << loadgame << "'" << std::endl;
+      return 1;
+    }
+    infile >> game;
+  }
+  const std::vector< KBX::Move > moves = game.validMoves();
+  if (moves.empty()) {
+    std::cerr << "position has no valid moves" << std::endl;
+    return 1;
+  }
+  // all theoretical moves of all dice of the player with next move
+  std::vector< KBX::Move > candidates;
+  for (size_t d = 0; d < game.getNumberOfDice(); d++) {
+    KBX::DieState& die = game.getDie(d);
+    if (die.getColor() == game.getNext()) {
+      for (size_t i = 0; i < KBX::DieState::nPossibleMoves[die.getValue()]; i++) {
+        candidates.push_back(KBX::Move(d, KBX::DieState::possibleMoves[die.getValue()][i]));
+      }
+    }
+  }
+  std::stringstream saved;
+  saved << game;
+  const std::string savegame = saved.str();
+
+  std::vector< Benchmark > benchmarks;
+  size_t iMove = 0;
+  size_t iCandidate = 0;
+  size_t iDie = 0;
+  benchmarks.push_back(Benchmark { "game.moveIsValid", [&]() {
+    iCandidate = (iCandidate + 1) % candidates.size();
+    sink = sink + game.moveIsValid(candidates[iCandidate]);
+  }});
+  benchmarks.push_back(Benchmark { "game.makeMove+undo", [&]() {
+    iMove = (iMove + 1) % moves.size();
+    KBX::Move mv = moves[iMove];
+    KBX::DieState& die = game.getDie(mv.dieIndex);
+    int victim = game.getDieId(die.x() + mv.rel.dx, die.y() + mv.rel.dy);
+    game.makeMove(mv, false);
+    game.makeMove(KBX::Move(mv.dieIndex, mv.rel.invert()), false);
+    if (victim != KBX::CLEAR) {
+      game.reviveDie(victim);
+    }
+  }});
+  benchmarks.push_back(Benchmark { "game.possibleMoves", [&]() {
+    iDie = (iDie + 1) % game.getNumberOfDice();
+    sink = sink + game.possibleMoves(iDie).size();
+  }});
+  benchmarks.push_back(Benchmark { KBX::stringprintf("game.evaluatePosition.depth%d", depth), [&]() {
+    sink = sink + game.evaluatePosition(depth);
+  }});
+  benchmarks.push_back(Benchmark { "game.rate", [&]() {
+    sink = sink + game.rate(game.getNext());
+  }});
+  benchmarks.push_back(Benchmark { "serialization.write", [&]() {
+    std::stringstream out;
+    out << game;
+    sink = sink + out.str().size();
+  }});
+  benchmarks.push_back(Benchmark { "serialization.roundtrip", [&]() {
+    std::stringstream out;
+    out << game;
+    KBX::Game copy((GameConfig()));
+    out >> copy;
+    sink = sink + copy.hash();
+  }});
+  benchmarks.push_back(Benchmark { "serialization.read", [&]() {
+    std::stringstream in(savegame);
+    KBX::Game copy((GameConfig()));
+    in >> copy;
+    sink = sink + copy.hash();
+  }});
+  KBX::Vec a(0.3f, -1.2f, 2.5f);
+  KBX::Vec b(1.0f, 0.5f, -0.25f);
+  benchmarks.push_back(Benchmark { "vec.add+scale", [&]() {
+    a = (a + b * 0.5f) - b.scaled(0.25f);
+    sink = sink + a.x;
+  }});
+  benchmarks.push_back(Benchmark { "vec.cross+normalized", [&]() {
+    KBX::Vec c = a.cross(b).normalized();
+    sink = sink + c.z;
+  }});
+  benchmarks.push_back(Benchmark { "vec.rotate", [&]() {
+    KBX::Vec c = a.rotate(b, 33.0f);
+    sink = sink + c.y;
+  }});
+  size_t colorId = 0;
+  benchmarks.push_back(Benchmark { "color.id", [&]() {
+    colorId = (colorId + 1) % (255 * 255);
+    sink = sink + KBX::Color(colorId).id();
+  }});
+
+  std::cout << "# benchmark\titerations\tns_per_op\tops_per_s" << std::endl;
+  for (size_t i = 0; i < benchmarks.size(); i++) {
+    if (benchmarks[i].name.find(filter) == std::string::npos) {
+      continue;
+    }
+    uint64_t iterations;
+    double ns = measure(benchmarks[i], minTime, iterations);
+    std::cout << benchmarks[i].name << "\t" << iterations << "\t"
+              << KBX::stringprintf("%.2f", ns) << "\t"
+              << KBX::stringprintf("%.0f", 1e9 / ns) << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,177 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// offline opening book builder.
+//
+// starting from the initial setup, every position of the book tree is
+// searched deeply, one root move per task, spread over all cores.
+// the best moves (up to --width per position, within --margin of the
+// best rating) are stored with weights and followed to the next ply.
+
+#include <stdlib.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+
+#include "engine.hpp"
+#include "book.hpp"
+#include "util.hpp"
+
+namespace {
+
+/// a single root move of a book position, to be rated by a deep search
+struct Task {
+  size_t position;
+  KBX::Move move;
+  float rating;
+};
+
+bool betterRating(const Task& lhs, const Task& rhs) {
+  return lhs.rating > rhs.rating;
+}
+
+void usage() {
+  std::cerr << "usage: kubix_book [--plies N] [--depth N] [--width N] [--margin R] [--threads N] [--out FILE]" << std::endl
+            << "  --plies    number of plies covered by the book (default 4)" << std::endl
+            << "  --depth    search depth in plies for every book move (default 6)" << std::endl
+            << "  --width    maximum number of moves stored per position (default 4)" << std::endl
+            << "  --margin   store moves rated at most this much below the best one (default 1.0)" << std::endl
+            << "  --threads  number of worker threads (default: all cores)" << std::endl
+            << "  --out      name of the book file (default kubix.book)" << std::endl;
+}
+
+/// rate all tasks by deep searches, distributed over nThreads workers
+void rateTasks(std::vector< KBX::Game >& positions, std::vector< Task >& tasks, int depth, size_t nThreads) {
+  std::atomic< size_t > next(0);
+  std::vector< std::thread > workers;
+  for (size_t t = 0; t < nThreads; t++) {
+    workers.push_back(std::thread([&]() {
+      for (size_t i = next++; i < tasks.size(); i = next++) {
+        KBX::Game game(positions[tasks[i].position]);
+        float patience = game.getStrategy().patience;
+        game.makeMove(tasks[i].move, false);
+        tasks[i].rating = - patience * game.evaluatePosition(depth - 1);
+      }
+    }));
+  }
+  for (size_t t = 0; t < workers.size(); t++) {
+    workers[t].join();
+  }
+}
+
+} // end anonymous namespace
+
+int main(int argc, char** argv) {
+  int plies = 4;
+  int depth = 6;
+  size_t width = 4;
+  float margin = 1.0f;
+  size_t nThreads = std::max(1u, std::thread::hardware_concurrency());
+  std::string outfile = "kubix.book";
+  for (int i = 1; i < argc; i++) {
+    std::string arg(argv[i]);
+    if (i + 1 >= argc) {
+      usage();
+      return 1;
+    }
+    std::string val(argv[++i]);
+    if (arg == "--plies") {
+      plies = atoi(val.c_str());
+    } else if (arg == "--depth") {
+      depth = atoi(val.c_str());
+    } else if (arg == "--width") {
+      width = atoi(val.c_str());
+    } else if (arg == "--margin") {
+      margin = atof(val.c_str());
+    } else if (arg == "--threads") {
+      nThreads = std::max(1, atoi(val.c_str()));
+    } else if (arg == "--out") {
+      outfile = val;
+    } else {
+      usage();
+      return 1;
+    }
+  }
+  if (plies < 1 || depth < 1 || width < 1) {
+    usage();
+    return 1;
+  }
+
+  std::vector< KBX::OpeningBook::Entry > entries;
+  std::vector< KBX::Game > positions(1, KBX::Game(GameConfig()));
+  std::set< uint64_t > known;
+  known.insert(positions[0].canonicalHash());
+  for (int ply = 0; ply < plies && !positions.empty(); ply++) {
+    // collect all root moves of the current book positions
+    std::vector< Task > tasks;
+    for (size_t p = 0; p < positions.size(); p++) {
+      std::vector< KBX::Move > moves = positions[p].validMoves();
+      for (size_t i = 0; i < moves.size(); i++) {
+        Task t = {p, moves[i], 0.0f};
+        tasks.push_back(t);
+      }
+    }
+    std::cerr << "ply " << ply + 1 << ": searching " << tasks.size() << " moves of " << positions.size()
+              << " positions" << std::endl;
+    rateTasks(positions, tasks, depth, nThreads);
+    // store best moves per position and expand them
+    std::vector< KBX::Game > nextPositions;
+    size_t begin = 0;
+    while (begin < tasks.size()) {
+      size_t end = begin;
+      while (end < tasks.size() && tasks[end].position == tasks[begin].position) {
+        end++;
+      }
+      std::stable_sort(tasks.begin() + begin, tasks.begin() + end, betterRating);
+      KBX::Game& game = positions[tasks[begin].position];
+      float best = tasks[begin].rating;
+      for (size_t i = begin; i < end && i - begin < width; i++) {
+        float loss = best - tasks[i].rating;
+        if (loss > margin) {
+          break;
+        }
+        // best move gets full weight, weaker moves less (down to 1 at the margin)
+        uint16_t weight = 1 + (uint16_t) (65534 * (margin > 0.0f ? 1.0f - loss / margin : 1.0f));
+        KBX::DieState& die = game.getDie(tasks[i].move.dieIndex);
+        if (game.isCanonical()) {
+          entries.push_back(KBX::OpeningBook::Entry(game.canonicalHash(), die.x(), die.y(), tasks[i].move.rel, weight));
+        } else {
+          entries.push_back(KBX::OpeningBook::Entry(game.canonicalHash(), 8 - die.x(), 8 - die.y(),
+                                                    tasks[i].move.rel.rotate(), weight));
+        }
+        KBX::Game child(game);
+        child.makeMove(tasks[i].move, false);
+        // positions equivalent by symmetry are expanded only once
+        if (child.getWinner() == KBX::NONE_OF_BOTH && known.insert(child.canonicalHash()).second) {
+          nextPositions.push_back(child);
+        }
+      }
+      begin = end;
+    }
+    positions.swap(nextPositions);
+  }
+  if ( !KBX::OpeningBook::write(outfile, entries)) {
+    return 1;
+  }
+  std::cerr << "wrote " << entries.size() << " book moves to '" << outfile << "'" << std::endl;
+  return 0;
+}
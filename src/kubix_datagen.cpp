@@ -0,0 +1,166 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// self-play training data generator.
+//
+// every worker thread plays games from random openings. every position
+// after the opening is searched, then stored with search rating, best
+// move and (once the game is over) the final result as a fixed-size
+// record (see training.hpp). records are collected in a buffer per
+// thread and appended to the output file whenever the buffer is full,
+// without any lock between the workers. games are played with
+// Game::playMove, so no undo history is kept.
+
+#include <stdlib.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+#include "engine.hpp"
+#include "training.hpp"
+#include "util.hpp"
+
+namespace {
+
+/// play a single game from a random opening and append its positions to records
+void playGame(std::mt19937_64& rng, int depth, size_t openingPlies, size_t maxPlies,
+              std::vector< KBX::TrainingRecord >& records) {
+  KBX::Game game((GameConfig()));
+  game.setRandomSeed(rng());
+  size_t first = records.size();
+  for (size_t ply = 0; ply < maxPlies; ply++) {
+    if (game.getWinner() != KBX::NONE_OF_BOTH || game.isDraw()) {
+      break;
+    }
+    std::vector< KBX::Move > moves = game.validMoves();
+    if (moves.empty()) {
+      break;
+    }
+    if (ply < openingPlies) {
+      game.playMove(moves[rng() % moves.size()]);
+      continue;
+    }
+    KBX::Evaluation eval = game.searchBestMove(depth);
+    records.push_back(KBX::TrainingRecord(game, ply, eval));
+    game.playMove(eval.move);
+  }
+  // the last ply may have decided the game; overlong games count as draws
+  KBX::PlayColor winner = game.getWinner();
+  for (size_t i = first; i < records.size(); i++) {
+    records[i].setResult(winner);
+  }
+}
+
+void usage() {
+  std::cerr << "usage: kubix_datagen [options]" << std::endl
+            << "  --games N          number of games (default 1000)" << std::endl
+            << "  --depth N          search depth in plies (default 4)" << std::endl
+            << "  --opening-plies N  number of random plies at the start of every game (default 8)" << std::endl
+            << "  --max-plies N      games longer than this are drawn (default 300)" << std::endl
+            << "  --buffer N         number of records buffered per thread (default 4096)" << std::endl
+            << "  --seed N           seed of the random openings and engine choices (default 1)" << std::endl
+            << "  --threads N        number of worker threads (default: all cores)" << std::endl
+            << "  --out FILE         name of the training data file (default kubix.train)" << std::endl;
+}
+
+} // end anonymous namespace
+
+int main(int argc, char** argv) {
+  size_t nGames = 1000;
+  int depth = 4;
+  size_t openingPlies = 8;
+  size_t maxPlies = 300;
+  size_t bufferSize = 4096;
+  uint64_t seed = 1;
+  size_t nThreads = std::max(1u, std::thread::hardware_concurrency());
+  std::string outfile = "kubix.train";
+  for (int i = 1; i < argc; i++) {
+    std::string arg(argv[i]);
+    if (i + 1 >= argc) {
+      usage();
+      return 1;
+    }
+    std::string val(argv[++i]);
+    if (arg == "--games") {
+      nGames = atoi(val.c_str());
+    } else if (arg == "--depth") {
+      depth = atoi(val.c_str());
+    } else if (arg == "--opening-plies") {
+      openingPlies = atoi(val.c_str());
+    } else if (arg == "--max-plies") {
+      maxPlies = atoi(val.c_str());
+    } else if (arg == "--buffer") {
+      bufferSize = std::max(1, atoi(val.c_str()));
+    } else if (arg == "--seed") {
+      seed = strtoull(val.c_str(), NULL, 10);
+    } else if (arg == "--threads") {
+      nThreads = std::max(1, atoi(val.c_str()));
+    } else if (arg == "--out") {
+      outfile = val;
+    } else {
+      usage();
+      return 1;
+    }
+  }
+  if (depth < 1) {
+    usage();
+    return 1;
+  }
+
+  KBX::TrainingFile file;
+  if ( !file.open(outfile)) {
+    return 1;
+  }
+  std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+  std::atomic< size_t > next(0);
+  std::atomic< bool > failed(false);
+  std::vector< std::thread > workers;
+  for (size_t t = 0; t < nThreads; t++) {
+    workers.push_back(std::thread([&]() {
+      std::vector< KBX::TrainingRecord > buffer;
+      buffer.reserve(bufferSize + maxPlies);
+      for (size_t g = next++; g < nGames && !failed; g = next++) {
+        // every game has its own seed, so the data does not depend on the number of threads
+        std::mt19937_64 rng(seed + g);
+        playGame(rng, depth, openingPlies, maxPlies, buffer);
+        if (buffer.size() >= bufferSize) {
+          failed = failed || !file.append(buffer);
+          buffer.clear();
+        }
+      }
+      failed = failed || !file.append(buffer);
+    }));
+  }
+  for (size_t t = 0; t < workers.size(); t++) {
+    workers[t].join();
+  }
+  uint64_t nRecords = file.size();
+  if ( !file.close() || failed) {
+    std::cerr << "cannot write '" << outfile << "'" << std::endl;
+    return 1;
+  }
+  double seconds = std::chrono::duration< double >(std::chrono::high_resolution_clock::now() - start).count();
+  std::cerr << "wrote " << nRecords << " positions of " << nGames << " games to '" << outfile << "' in "
+            << KBX::stringprintf("%.1f", seconds) << " s" << std::endl;
+  return 0;
+}
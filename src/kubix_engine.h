@@ -0,0 +1,89 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KUBIX_ENGINE__H
+#define KUBIX_ENGINE__H
+
+/*
+ C interface of the kubix_engine library.
+
+ moves are given in text notation (see KBX::Game::moveToString), games
+ in .kbx savegame format. functions writing text to a buffer behave like
+ snprintf: they write at most 'size' bytes (including the terminating
+ null byte) and return the length of the complete text, so a too small
+ buffer can be detected and enlarged. no function throws; errors are
+ reported by return values.
+ the C++ interface are the headers engine.hpp, book.hpp and training.hpp.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* colors, as returned by kbx_game_next and kbx_game_winner */
+#define KBX_WHITE 1
+#define KBX_BLACK -1
+#define KBX_NONE 0
+
+/* a game with board, history and engine settings */
+typedef struct kbx_game kbx_game;
+
+/* version of the library, e.g. "0.1" */
+const char* kbx_version(void);
+
+/* new game in initial setup; NULL if out of memory */
+kbx_game* kbx_game_new(void);
+/* game read from a .kbx savegame; NULL if the savegame cannot be read */
+kbx_game* kbx_game_load(const char* savegame);
+void kbx_game_free(kbx_game* game);
+/* write game as .kbx savegame */
+size_t kbx_game_save(kbx_game* game, char* buffer, size_t size);
+
+/* player with next move: KBX_WHITE or KBX_BLACK */
+int kbx_game_next(kbx_game* game);
+/* KBX_WHITE, KBX_BLACK or KBX_NONE, if the game is not won yet */
+int kbx_game_winner(kbx_game* game);
+/* 1, if the game is drawn by repetition, else 0 */
+int kbx_game_is_draw(kbx_game* game);
+/* zobrist hash of the position */
+uint64_t kbx_game_hash(kbx_game* game);
+
+/* write all valid moves of the player with next move, separated by spaces */
+size_t kbx_game_moves(kbx_game* game, char* buffer, size_t size);
+/* perform move; returns 0 on success, -1 if the move is not valid */
+int kbx_game_play(kbx_game* game, const char* move);
+/* take back last move; returns 0 on success, -1 if there is no move to take back */
+int kbx_game_undo(kbx_game* game);
+
+/* search best move with given depth in plies and write it to 'move';
+   the rating (for the player with next move) is stored in 'rating', unless it is NULL.
+   returns 0 on success, -1 if there is no valid move */
+int kbx_game_search(kbx_game* game, int depth, char* move, size_t size, float* rating);
+/* make the choice between equally rated moves of the following searches reproducible:
+   the same seed gives the same move for the same position (0: random, the default) */
+void kbx_game_set_seed(kbx_game* game, uint64_t seed);
+/* count leaf nodes of the game tree up to the given depth */
+uint64_t kbx_game_perft(kbx_game* game, int depth);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,161 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// perft: count leaf nodes of the game tree to measure the speed
+// and check the correctness of move generation.
+//
+// the root moves are distributed over all worker threads.
+// with --divide, the count of every root move is printed.
+// with --verify, the counts are compared to a reference file
+// with lines '<depth> <nodes>'.
+
+#include <stdlib.h>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+#include "engine.hpp"
+#include "util.hpp"
+
+namespace {
+
+void usage() {
+  std::cerr << "usage: kubix_perft [--depth N] [--divide] [--threads N] [--load-game FILE] [--verify FILE]" << std::endl
+            << "  --depth      depth in plies (default 3)" << std::endl
+            << "  --divide     print node count per root move" << std::endl
+            << "  --threads    number of worker threads (default: all cores)" << std::endl
+            << "  --load-game  start from a saved game instead of the initial setup" << std::endl
+            << "  --verify     compare with reference counts ('<depth> <nodes>' per line)" << std::endl;
+}
+
+/// count leaf nodes below every root move, distributed over nThreads workers
+std::vector< uint64_t > perftDivide(KBX::Game& game, const std::vector< KBX::Move >& moves, int depth,
+                                    size_t nThreads) {
+  std::vector< uint64_t > counts(moves.size(), 0);
+  std::atomic< size_t > next(0);
+  std::vector< std::thread > workers;
+  for (size_t t = 0; t < nThreads; t++) {
+    workers.push_back(std::thread([&]() {
+      for (size_t i = next++; i < moves.size(); i = next++) {
+        KBX::Game child(game);
+        child.makeMove(moves[i], false);
+        counts[i] = child.perft(depth - 1);
+      }
+    }));
+  }
+  for (size_t t = 0; t < workers.size(); t++) {
+    workers[t].join();
+  }
+  return counts;
+}
+
+/// run perft to the given depth, return total leaf count
+uint64_t runPerft(KBX::Game& game, int depth, bool divide, size_t nThreads) {
+  std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+  uint64_t nodes = 0;
+  if (depth == 0 || game.getWinner() != KBX::NONE_OF_BOTH) {
+    nodes = game.perft(depth);
+  } else {
+    std::vector< KBX::Move > moves = game.validMoves();
+    std::vector< uint64_t > counts = perftDivide(game, moves, depth, nThreads);
+    for (size_t i = 0; i < moves.size(); i++) {
+      if (divide) {
+        std::cout << game.moveToString(moves[i]) << " " << counts[i] << std::endl;
+      }
+      nodes += counts[i];
+    }
+  }
+  double seconds = std::chrono::duration< double >(std::chrono::high_resolution_clock::now() - start).count();
+  std::cout << "perft " << depth << " " << nodes << " nodes " << seconds << " s "
+            << (uint64_t) (nodes / std::max(seconds, 1e-9)) << " nps" << std::endl;
+  return nodes;
+}
+
+} // end anonymous namespace
+
+int main(int argc, char** argv) {
+  int depth = 3;
+  bool divide = false;
+  size_t nThreads = std::max(1u, std::thread::hardware_concurrency());
+  std::string loadgame = "";
+  std::string reference = "";
+  for (int i = 1; i < argc; i++) {
+    std::string arg(argv[i]);
+    if (arg == "--divide") {
+      divide = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      usage();
+      return 1;
+    }
+    std::string val(argv[++i]);
+    if (arg == "--depth") {
+      depth = atoi(val.c_str());
+    } else if (arg == "--threads") {
+      nThreads = std::max(1, atoi(val.c_str()));
+    } else if (arg == "--load-game") {
+      loadgame = val;
+    } else if (arg == "--verify") {
+      reference = val;
+    } else {
+      usage();
+      return 1;
+    }
+  }
+
+  KBX::Game game((GameConfig()));
+  if (loadgame.size() > 0) {
+    std::ifstream infile(loadgame);
+    if ( !infile.is_open()) {
+      std::cerr << "cannot open '" << loadgame << "'" << std::endl;
+      return 1;
+    }
+    infile >> game;
+    if (infile.fail()) {
+      std::cerr << "cannot read '" << loadgame << "'" << std::endl;
+      return 1;
+    }
+  }
+
+  if (reference.size() > 0) {
+    std::ifstream ref(reference);
+    if ( !ref.is_open()) {
+      std::cerr << "cannot open '" << reference << "'" << std::endl;
+      return 1;
+    }
+    int failures = 0;
+    int refDepth;
+    uint64_t refNodes;
+    while (ref >> refDepth >> refNodes) {
+      uint64_t nodes = runPerft(game, refDepth, divide, nThreads);
+      if (nodes != refNodes) {
+        std::cout << "FAILED: perft " << refDepth << " expected " << refNodes << std::endl;
+        failures++;
+      }
+    }
+    return (failures == 0) ? 0 : 1;
+  }
+  runPerft(game, depth, divide, nThreads);
+  return 0;
+}
@@ -0,0 +1,225 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// test-position suite runner.
+//
+// every line of the suite file holds one position:
+//   <id>|<best move> [<best move> ...]|<savegame in .kbx format>
+// empty lines and lines starting with '#' are ignored.
+//
+// every position is searched with increasing depth (1, 2, ... plies)
+// until --max-depth or --time-limit is reached. a position counts as
+// solved at the first depth from which on the engine sticks to a best
+// move. time and nodes to solution are summed up from the first
+// iteration. positions are distributed over --threads workers; every
+// single search runs on one thread. equally rated moves are chosen by a
+// random stream seeded from --seed and the position, so a run is
+// reproducible whatever the number of threads.
+//
+// the score is the sum of all times to solution, with unsolved
+// positions counted as the time limit: lower is better.
+
+#include <stdlib.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+#include "engine.hpp"
+#include "util.hpp"
+#include "alloc.hpp"
+
+namespace {
+
+typedef std::chrono::high_resolution_clock Clock;
+
+/// a test position with its known best move(s) and the result of the run
+struct TestPosition {
+  std::string id;
+  std::vector< std::string > bestMoves;
+  std::string savegame;
+  bool solved;
+  int depth;
+  double seconds;
+  uint64_t nodes;
+  KBX::SearchStats stats;
+};
+
+void usage() {
+  std::cerr << "usage: kubix_testsuite [--max-depth N] [--time-limit SECONDS] [--threads N] [--seed N] SUITE" << std::endl
+            << "  --max-depth   maximum search depth in plies (default 6)" << std::endl
+            << "  --time-limit  no new iteration is started after this time per position (default 10)" << std::endl
+            << "  --threads     number of positions searched at once (default 1)" << std::endl
+            << "  --seed        seed of the random choice between equally rated moves (default 1, 0: random)" << std::endl;
+}
+
+/// read test positions from suite file
+bool readSuite(const std::string& filename, std::vector< TestPosition >& positions) {
+  std::ifstream infile(filename);
+  if ( !infile.is_open()) {
+    std::cerr << "cannot open '" << filename << "'" << std::endl;
+    return false;
+  }
+  std::string line;
+  while (std::getline(infile, line)) {
+    line = KBX::trim(line);
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    size_t sep1 = line.find('|');
+    size_t sep2 = line.find('|', sep1 + 1);
+    if (sep1 == std::string::npos || sep2 == std::string::npos) {
+      std::cerr << "malformed line in '" << filename << "': " << line << std::endl;
+      return false;
+    }
+    TestPosition pos;
+    pos.id = KBX::trim(line.substr(0, sep1));
+    std::stringstream moves(line.substr(sep1 + 1, sep2 - sep1 - 1));
+    std::string mv;
+    while (moves >> mv) {
+      pos.bestMoves.push_back(mv);
+    }
+    pos.savegame = line.substr(sep2 + 1);
+    pos.solved = false;
+    pos.depth = 0;
+    pos.seconds = 0.0;
+    pos.nodes = 0;
+    positions.push_back(pos);
+  }
+  return true;
+}
+
+/// search position with increasing depth and record time and nodes to solution
+void solve(TestPosition& pos, int maxDepth, double timeLimit, uint64_t seed) {
+  KBX::Game game((GameConfig()));
+  std::stringstream in(pos.savegame);
+  in >> game;
+  game.setRandomSeed(seed);
+  Clock::time_point start = Clock::now();
+  uint64_t nodes = 0;
+  for (int depth = 1; depth <= maxDepth; depth++) {
+    game.resetNodeCount();
+    std::string best = game.moveToString(game.searchBestMove(depth).move);
+    nodes += game.nodeCount();
+    double seconds = std::chrono::duration< double >(Clock::now() - start).count();
+    if (std::find(pos.bestMoves.begin(), pos.bestMoves.end(), best) != pos.bestMoves.end()) {
+      if ( !pos.solved) {
+        pos.solved = true;
+        pos.depth = depth;
+        pos.seconds = seconds;
+        pos.nodes = nodes;
+      }
+    } else {
+      pos.solved = false;
+      pos.depth = 0;
+      pos.seconds = 0.0;
+      pos.nodes = 0;
+    }
+    if (seconds > timeLimit) {
+      break;
+    }
+  }
+  pos.stats = game.searchStats();
+}
+
+} // end anonymous namespace
+
+int main(int argc, char** argv) {
+  int maxDepth = 6;
+  double timeLimit = 10.0;
+  size_t nThreads = 1;
+  uint64_t seed = 1;
+  std::string suite = "";
+  for (int i = 1; i < argc; i++) {
+    std::string arg(argv[i]);
+    if (arg.compare(0, 2, "--") != 0) {
+      suite = arg;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      usage();
+      return 1;
+    }
+    std::string val(argv[++i]);
+    if (arg == "--max-depth") {
+      maxDepth = atoi(val.c_str());
+    } else if (arg == "--time-limit") {
+      timeLimit = atof(val.c_str());
+    } else if (arg == "--threads") {
+      nThreads = std::max(1, atoi(val.c_str()));
+    } else if (arg == "--seed") {
+      seed = strtoull(val.c_str(), NULL, 10);
+    } else {
+      usage();
+      return 1;
+    }
+  }
+  std::vector< TestPosition > positions;
+  if (suite.empty()) {
+    usage();
+    return 1;
+  }
+  if ( !readSuite(suite, positions)) {
+    return 1;
+  }
+
+  std::atomic< size_t > next(0);
+  std::vector< std::thread > workers;
+  for (size_t t = 0; t < nThreads; t++) {
+    workers.push_back(std::thread([&]() {
+      for (size_t i = next++; i < positions.size(); i = next++) {
+        solve(positions[i], maxDepth, timeLimit, seed);
+      }
+    }));
+  }
+  for (size_t t = 0; t < workers.size(); t++) {
+    workers[t].join();
+  }
+
+  size_t nSolved = 0;
+  double score = 0.0;
+  uint64_t totalNodes = 0;
+  KBX::SearchStats stats;
+  std::cout << "# id\tsolved\tdepth\tseconds\tnodes" << std::endl;
+  for (size_t i = 0; i < positions.size(); i++) {
+    TestPosition& pos = positions[i];
+    stats.merge(pos.stats);
+    std::cout << pos.id << "\t" << pos.solved << "\t" << pos.depth << "\t"
+              << KBX::stringprintf("%.4f", pos.seconds) << "\t" << pos.nodes << std::endl;
+    if (pos.solved) {
+      nSolved++;
+      score += pos.seconds;
+      totalNodes += pos.nodes;
+    } else {
+      score += timeLimit;
+    }
+  }
+  std::cout << "# solved " << nSolved << "/" << positions.size() << " threads " << nThreads
+            << " nodes-to-solution " << totalNodes << std::endl;
+  std::cout << "# search " << stats.summary() << std::endl;
+  if (KBX::AllocTracking::available()) {
+    std::cout << "# allocations by site:" << std::endl << KBX::AllocTracking::report();
+  }
+  std::cout << "# score " << KBX::stringprintf("%.4f", score) << std::endl;
+  return 0;
+}
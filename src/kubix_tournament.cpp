@@ -0,0 +1,302 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// headless self-play tournament between two engine configurations (A and B).
+//
+// games are played in pairs: both games of a pair start from the same
+// random opening, with colors swapped. pairs are distributed over all
+// worker threads. results are counted from the view of engine A and
+// reported as win/draw/loss, score and Elo difference with a 95% error
+// bar. with --sprt, the tournament stops as soon as the sequential
+// probability ratio test accepts one of the hypotheses
+// 'elo = ELO0' (H0) or 'elo = ELO1' (H1).
+
+#include <stdlib.h>
+#include <math.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <mutex>
+
+#include "engine.hpp"
+#include "util.hpp"
+
+namespace {
+
+/// an engine configuration taking part in the tournament
+struct Player {
+  KBX::Strategy strategy;
+  int depth;
+};
+
+/// accumulated results from the view of engine A
+struct Results {
+  size_t wins;
+  size_t draws;
+  size_t losses;
+  size_t games() const {
+    return wins + draws + losses;
+  }
+  double score() const {
+    return (wins + 0.5 * draws) / games();
+  }
+};
+
+/// convert a score (0..1) to an Elo difference
+double eloFromScore(double score) {
+  score = std::min(std::max(score, 1e-6), 1.0 - 1e-6);
+  return -400.0 * log10(1.0 / score - 1.0);
+}
+
+/// Elo difference and half width of its 95% confidence interval
+void elo(const Results& r, double& diff, double& error) {
+  size_t n = r.games();
+  double s = r.score();
+  double variance = (r.wins * (1.0 - s) * (1.0 - s) + r.draws * (0.5 - s) * (0.5 - s) + r.losses * s * s) / n;
+  double delta = 1.959964 * sqrt(variance / n);
+  diff = eloFromScore(s);
+  error = (eloFromScore(s + delta) - eloFromScore(s - delta)) / 2.0;
+}
+
+/// win and loss probabilities for an Elo difference in the BayesElo draw model
+void bayesProbabilities(double bayesElo, double drawElo, double& pWin, double& pLoss) {
+  pWin = 1.0 / (1.0 + pow(10.0, (drawElo - bayesElo) / 400.0));
+  pLoss = 1.0 / (1.0 + pow(10.0, (drawElo + bayesElo) / 400.0));
+}
+
+/// log-likelihood ratio of H1 (elo = elo1) vs. H0 (elo = elo0)
+/**
+ the draw rate is estimated from the results, the hypotheses are
+ converted from logistic Elo to the BayesElo scale.
+ */
+double sprtLLR(const Results& r, double elo0, double elo1) {
+  if (r.wins == 0 || r.losses == 0) {
+    return 0.0;
+  }
+  double n = r.games();
+  double w = r.wins / n;
+  double l = r.losses / n;
+  double drawElo = 200.0 * log10((1.0 - l) / l * (1.0 - w) / w);
+  double x = pow(10.0, -drawElo / 400.0);
+  double scale = 4.0 * x / ((1.0 + x) * (1.0 + x));
+  double pWin0, pLoss0, pWin1, pLoss1;
+  bayesProbabilities(elo0 / scale, drawElo, pWin0, pLoss0);
+  bayesProbabilities(elo1 / scale, drawElo, pWin1, pLoss1);
+  double llr = r.wins * log(pWin1 / pWin0) + r.losses * log(pLoss1 / pLoss0);
+  // without draws, the estimated draw probability is zero under both hypotheses
+  if (r.draws > 0) {
+    llr += r.draws * log((1.0 - pWin1 - pLoss1) / (1.0 - pWin0 - pLoss0));
+  }
+  return llr;
+}
+
+/// play random moves from the initial setup, avoiding finished games
+KBX::Game randomOpening(size_t plies, uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  while (true) {
+    KBX::Game game((GameConfig()));
+    size_t ply = 0;
+    for (; ply < plies && game.getWinner() == KBX::NONE_OF_BOTH; ply++) {
+      std::vector< KBX::Move > moves = game.validMoves();
+      if (moves.empty()) {
+        break;
+      }
+      game.makeMove(moves[rng() % moves.size()], true);
+    }
+    if (ply == plies && game.getWinner() == KBX::NONE_OF_BOTH) {
+      return game;
+    }
+  }
+}
+
+/// play a game to the end, return the winner (NONE_OF_BOTH for a draw)
+KBX::PlayColor play(KBX::Game& game, const Player& white, const Player& black, size_t maxPlies) {
+  for (size_t ply = 0; ply < maxPlies; ply++) {
+    if (game.getWinner() != KBX::NONE_OF_BOTH) {
+      return game.getWinner();
+    }
+    if (game.isDraw() || game.validMoves().empty()) {
+      return KBX::NONE_OF_BOTH;
+    }
+    const Player& player = (game.getNext() == KBX::WHITE) ? white : black;
+    game.getStrategy() = player.strategy;
+    game.makeMove(game.searchBestMove(player.depth).move, true);
+  }
+  // adjudicate overlong games as draws
+  return game.getWinner();
+}
+
+/// read strategy from its .kbx (json) representation
+KBX::Strategy parseStrategy(const std::string& json) {
+  KBX::Strategy s;
+  std::stringstream in(json);
+  in >> s;
+  return s;
+}
+
+void usage() {
+  std::cerr << "usage: kubix_tournament [options]" << std::endl
+            << "  --games N          number of games, played in pairs with swapped colors (default 1000)" << std::endl
+            << "  --depth-a N        search depth of engine A in plies (default 4)" << std::endl
+            << "  --depth-b N        search depth of engine B in plies (default 4)" << std::endl
+            << "  --strategy-a JSON  strategy of engine A, e.g. '{\"name\":\"a\",\"coeffDR\":1,\"pat\":0.95}'" << std::endl
+            << "  --strategy-b JSON  strategy of engine B" << std::endl
+            << "  --opening-plies N  number of random plies before the engines take over (default 4)" << std::endl
+            << "  --max-plies N      games longer than this are drawn (default 300)" << std::endl
+            << "  --sprt ELO0 ELO1   stop early when the SPRT (alpha = beta = 0.05) accepts a hypothesis" << std::endl
+            << "  --save-games DIR   write every game as .kbx savegame to DIR (e.g. as data for kubix_tune)" << std::endl
+            << "  --seed N           seed of the random openings and engine choices (default 1)" << std::endl
+            << "  --threads N        number of worker threads (default: all cores)" << std::endl;
+}
+
+} // end anonymous namespace
+
+int main(int argc, char** argv) {
+  size_t nGames = 1000;
+  Player a;
+  a.depth = 4;
+  Player b;
+  b.depth = 4;
+  size_t openingPlies = 4;
+  size_t maxPlies = 300;
+  bool sprt = false;
+  double elo0 = 0.0;
+  double elo1 = 0.0;
+  uint64_t seed = 1;
+  std::string saveDir = "";
+  size_t nThreads = std::max(1u, std::thread::hardware_concurrency());
+  for (int i = 1; i < argc; i++) {
+    std::string arg(argv[i]);
+    if (i + 1 >= argc) {
+      usage();
+      return 1;
+    }
+    std::string val(argv[++i]);
+    if (arg == "--games") {
+      nGames = std::max(2, atoi(val.c_str()));
+    } else if (arg == "--depth-a") {
+      a.depth = atoi(val.c_str());
+    } else if (arg == "--depth-b") {
+      b.depth = atoi(val.c_str());
+    } else if (arg == "--strategy-a") {
+      a.strategy = parseStrategy(val);
+    } else if (arg == "--strategy-b") {
+      b.strategy = parseStrategy(val);
+    } else if (arg == "--opening-plies") {
+      openingPlies = atoi(val.c_str());
+    } else if (arg == "--max-plies") {
+      maxPlies = atoi(val.c_str());
+    } else if (arg == "--sprt" && i + 1 < argc) {
+      sprt = true;
+      elo0 = atof(val.c_str());
+      elo1 = atof(argv[++i]);
+    } else if (arg == "--save-games") {
+      saveDir = val;
+    } else if (arg == "--seed") {
+      seed = strtoull(val.c_str(), NULL, 10);
+    } else if (arg == "--threads") {
+      nThreads = std::max(1, atoi(val.c_str()));
+    } else {
+      usage();
+      return 1;
+    }
+  }
+  if (a.depth < 1 || b.depth < 1) {
+    usage();
+    return 1;
+  }
+  const double alpha = 0.05;
+  const double beta = 0.05;
+  const double lowerBound = log(beta / (1.0 - alpha));
+  const double upperBound = log((1.0 - beta) / alpha);
+
+  Results results = {0, 0, 0};
+  std::mutex resultsMutex;
+  std::atomic< size_t > next(0);
+  std::atomic< bool > stop(false);
+  size_t nPairs = (nGames + 1) / 2;
+  std::vector< std::thread > workers;
+  for (size_t t = 0; t < nThreads; t++) {
+    workers.push_back(std::thread([&]() {
+      for (size_t pair = next++; pair < nPairs && !stop; pair = next++) {
+        KBX::Game opening = randomOpening(openingPlies, seed + pair);
+        // both games of a pair break ties between equally rated moves alike
+        opening.setRandomSeed(seed + pair);
+        for (int round = 0; round < 2 && !stop; round++) {
+          // engine A plays white in the first game of a pair and black in the second one
+          KBX::PlayColor colorA = (round == 0) ? KBX::WHITE : KBX::BLACK;
+          KBX::Game game(opening);
+          KBX::PlayColor winner = (round == 0) ? play(game, a, b, maxPlies) : play(game, b, a, maxPlies);
+          if ( !saveDir.empty()) {
+            std::ofstream outfile(KBX::stringprintf("%s/game_%06zu.kbx", saveDir.c_str(), 2 * pair + round));
+            outfile << game;
+          }
+          std::lock_guard< std::mutex > lock(resultsMutex);
+          if (winner == KBX::NONE_OF_BOTH) {
+            results.draws++;
+          } else if (winner == colorA) {
+            results.wins++;
+          } else {
+            results.losses++;
+          }
+          if (results.games() % 100 == 0) {
+            std::cerr << "games " << results.games() << ": " << results.wins << "/" << results.draws << "/"
+                      << results.losses << std::endl;
+          }
+          if (sprt) {
+            double llr = sprtLLR(results, elo0, elo1);
+            if (llr <= lowerBound || llr >= upperBound) {
+              stop = true;
+            }
+          }
+        }
+      }
+    }));
+  }
+  for (size_t t = 0; t < workers.size(); t++) {
+    workers[t].join();
+  }
+
+  double diff, error;
+  elo(results, diff, error);
+  std::cout << "engine A: depth " << a.depth << " strategy " << a.strategy << std::endl
+            << "engine B: depth " << b.depth << " strategy " << b.strategy << std::endl
+            << "games " << results.games() << " W/D/L " << results.wins << "/" << results.draws << "/"
+            << results.losses << std::endl
+            << "score " << KBX::stringprintf("%.4f", results.score()) << " elo "
+            << KBX::stringprintf("%.1f +/- %.1f", diff, error) << std::endl;
+  if (sprt) {
+    double llr = sprtLLR(results, elo0, elo1);
+    std::cout << "sprt [" << elo0 << ", " << elo1 << "] llr "
+              << KBX::stringprintf("%.3f [%.3f, %.3f]", llr, lowerBound, upperBound) << " ";
+    if (llr >= upperBound) {
+      std::cout << "H1 accepted" << std::endl;
+    } else if (llr <= lowerBound) {
+      std::cout << "H0 accepted" << std::endl;
+    } else {
+      std::cout << "inconclusive" << std::endl;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,247 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// evaluation tuner (Texel's method).
+//
+// every position of the given finished games (.kbx savegames, e.g. written
+// by 'kubix_tournament --save-games DIR') is labeled with the final result
+// from the view of the player with next move (1, 0.5 or 0). the weights of
+// the rating functions (see Strategy::ratingWeights) are then fitted by a
+// local search minimizing the mean squared error between these results and
+//   sigmoid(K * rating)
+// K fixes the scale of the ratings: since a won game is rated 100, the
+// default K = ln(99)/100 maps a rating of 100 to a 99% expected score.
+// the tuned strategy is written in .kbx format.
+//
+// the error is computed in parallel over all cores. the rating terms are
+// stored column-wise, so that the inner loops run over contiguous arrays.
+
+#include <stdlib.h>
+#include <math.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <thread>
+
+#include "engine.hpp"
+#include "util.hpp"
+
+namespace {
+
+/// positions of all games, labeled with the result
+struct Dataset {
+  // terms[j][i]: rating term j of position i
+  std::vector< std::vector< float > > terms;
+  // result[i]: final result from the view of the player with next move in position i
+  std::vector< float > results;
+  size_t size() const {
+    return results.size();
+  }
+};
+
+/// add all positions of a finished game to the dataset, return false if game is not finished
+bool addGame(KBX::Game& game, Dataset& data) {
+  KBX::PlayColor winner = game.getWinner();
+  if (winner == KBX::NONE_OF_BOTH && !game.isDraw()) {
+    return false;
+  }
+  // replay game from the start
+  while (game.undoMove().dieIndex != -1) {
+  }
+  do {
+    if (game.getWinner() != KBX::NONE_OF_BOTH) {
+      break;
+    }
+    KBX::PlayColor next = game.getNext();
+    std::vector< float > terms = game.ratingTerms(next);
+    data.terms.resize(terms.size());
+    for (size_t j = 0; j < terms.size(); j++) {
+      data.terms[j].push_back(terms[j]);
+    }
+    if (winner == KBX::NONE_OF_BOTH) {
+      data.results.push_back(0.5f);
+    } else {
+      data.results.push_back((winner == next) ? 1.0f : 0.0f);
+    }
+  } while (game.redoMove().dieIndex != -1);
+  return true;
+}
+
+/// squared error sum over positions [begin, end)
+double partialError(const Dataset& data, const std::vector< double >& weights, double k, size_t begin,
+                    size_t end) {
+  const size_t blockSize = 1024;
+  std::vector< float > ratings(blockSize);
+  const float kf = k;
+  double sum = 0.0;
+  for (size_t block = begin; block < end; block += blockSize) {
+    size_t n = std::min(blockSize, end - block);
+    std::fill(ratings.begin(), ratings.begin() + n, 0.0f);
+    for (size_t j = 0; j < weights.size(); j++) {
+      const float w = weights[j];
+      const float* terms = &data.terms[j][block];
+      for (size_t i = 0; i < n; i++) {
+        ratings[i] += w * terms[i];
+      }
+    }
+    const float* results = &data.results[block];
+    for (size_t i = 0; i < n; i++) {
+      float d = results[i] - 1.0f / (1.0f + expf( -kf * ratings[i]));
+      sum += d * d;
+    }
+  }
+  return sum;
+}
+
+/// mean squared error of the predicted vs. the real results, computed by nThreads workers
+double meanError(const Dataset& data, const std::vector< double >& weights, double k, size_t nThreads) {
+  std::vector< double > sums(nThreads, 0.0);
+  std::vector< std::thread > workers;
+  size_t chunk = (data.size() + nThreads - 1) / nThreads;
+  for (size_t t = 0; t < nThreads; t++) {
+    size_t begin = std::min(data.size(), t * chunk);
+    size_t end = std::min(data.size(), begin + chunk);
+    workers.push_back(std::thread([&, t, begin, end]() {
+      sums[t] = partialError(data, weights, k, begin, end);
+    }));
+  }
+  double sum = 0.0;
+  for (size_t t = 0; t < workers.size(); t++) {
+    workers[t].join();
+    sum += sums[t];
+  }
+  return sum / data.size();
+}
+
+void usage() {
+  std::cerr << "usage: kubix_tune [options] GAME.kbx [GAME.kbx ...]" << std::endl
+            << "  --strategy JSON  initial strategy (default: built-in strategy)" << std::endl
+            << "  --k K            scale of the logistic function (default ln(99)/100)" << std::endl
+            << "  --step S         initial step width of the weights (default 0.1)" << std::endl
+            << "  --iterations N   maximum number of iterations (default 1000)" << std::endl
+            << "  --threads N      number of worker threads (default: all cores)" << std::endl
+            << "  --out FILE       write tuned strategy to FILE instead of stdout" << std::endl;
+}
+
+} // end anonymous namespace
+
+int main(int argc, char** argv) {
+  KBX::Strategy strategy;
+  double k = log(99.0) / 100.0;
+  double step = 0.1;
+  const double minStep = 0.001;
+  size_t maxIterations = 1000;
+  size_t nThreads = std::max(1u, std::thread::hardware_concurrency());
+  std::string outfile = "";
+  std::vector< std::string > files;
+  for (int i = 1; i < argc; i++) {
+    std::string arg(argv[i]);
+    if (arg.compare(0, 2, "--") != 0) {
+      files.push_back(arg);
+      continue;
+    }
+    if (i + 1 >= argc) {
+      usage();
+      return 1;
+    }
+    std::string val(argv[++i]);
+    if (arg == "--strategy") {
+      std::stringstream in(val);
+      in >> strategy;
+    } else if (arg == "--k") {
+      k = atof(val.c_str());
+    } else if (arg == "--step") {
+      step = atof(val.c_str());
+    } else if (arg == "--iterations") {
+      maxIterations = atoi(val.c_str());
+    } else if (arg == "--threads") {
+      nThreads = std::max(1, atoi(val.c_str()));
+    } else if (arg == "--out") {
+      outfile = val;
+    } else {
+      usage();
+      return 1;
+    }
+  }
+  if (files.empty()) {
+    usage();
+    return 1;
+  }
+
+  Dataset data;
+  size_t nGames = 0;
+  for (size_t f = 0; f < files.size(); f++) {
+    std::ifstream infile(files[f]);
+    if ( !infile.is_open()) {
+      std::cerr << "cannot open '" << files[f] << "'" << std::endl;
+      return 1;
+    }
+    KBX::Game game((GameConfig()));
+    infile >> game;
+    if (addGame(game, data)) {
+      nGames++;
+    }
+  }
+  if (data.size() == 0) {
+    std::cerr << "no positions of finished games found" << std::endl;
+    return 1;
+  }
+  std::cerr << nGames << " games, " << data.size() << " positions" << std::endl;
+
+  // local search: move every weight by +-step as long as the error decreases,
+  // then halve the step
+  std::vector< double > weights = strategy.ratingWeights();
+  double error = meanError(data, weights, k, nThreads);
+  std::cerr << "initial error " << KBX::stringprintf("%.6f", error) << std::endl;
+  for (size_t iteration = 0; iteration < maxIterations && step >= minStep; iteration++) {
+    bool improved = false;
+    for (size_t j = 0; j < weights.size(); j++) {
+      for (int sign = 1; sign >= -1; sign -= 2) {
+        std::vector< double > candidate(weights);
+        candidate[j] += sign * step;
+        double candidateError = meanError(data, candidate, k, nThreads);
+        if (candidateError < error) {
+          weights = candidate;
+          error = candidateError;
+          improved = true;
+          break;
+        }
+      }
+    }
+    if ( !improved) {
+      step /= 2.0;
+    }
+  }
+  std::cerr << "final error " << KBX::stringprintf("%.6f", error) << std::endl;
+
+  strategy.setRatingWeights(weights);
+  if (outfile.empty()) {
+    std::cout << strategy << std::endl;
+  } else {
+    std::ofstream out(outfile);
+    if ( !out.is_open()) {
+      std::cerr << "cannot write '" << outfile << "'" << std::endl;
+      return 1;
+    }
+    out << strategy << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,858 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// headless engine speaking a line-based protocol on stdin/stdout,
+// modelled after UCI. commands:
+//
+//   uci                                  identify, list options, answer 'uciok'
+//   isready                              answer 'readyok'
+//   setoption name <name> value <value>  RepetitionDraw, Strategy (JSON) or Seed
+//   ucinewgame                           reset to the initial setup
+//   position startpos [moves <m> ...]    initial setup plus moves
+//   position kbx <savegame> [moves <m> ...]
+//   go [depth N] [movetime MS] [nodes N] [infinite]
+//   stop                                 finish the running search
+//   d                                    print the position as 'kbx <savegame>'
+//   quit
+//
+// moves are given in text notation (e.g. 'c1c3', 'd1e6y'). 'go' searches
+// with increasing depth on a worker thread and prints
+//   info depth D score cp S nodes N time MS nps X pv MOVE ...
+// after every finished iteration, where S is the rating of the player
+// with next move times 100. the search ends with 'bestmove MOVE' (or
+// 'bestmove (none)', if the game is over): the move of the deepest
+// finished iteration. stop, time and node limits are checked at every
+// node, so 'bestmove' follows within a few microseconds.
+//
+// server mode (--server SOCKET) speaks the same protocol on a Unix domain
+// socket, one session per connection. 'go' needs a limit there; it is
+// queued for a shared pool of worker threads and answered as on stdin
+// by an info line per finished iteration (starting with a cached result,
+// if any), a final info line with the full principal variation and
+// 'bestmove'. 'stop',
+// 'quit' or closing the connection cancel the session's search; other
+// commands sent meanwhile are answered after 'bestmove'. finished
+// iterations are stored in an analysis cache shared by all connections,
+// so repeated positions continue from the deepest known result instead
+// of starting over. 'stats' reports requests, throughput, latency
+// percentiles (from arrival of 'go' to 'bestmove') and cache hits.
+// --connect SOCKET runs concurrent clients against a server and reports
+// the same figures from the client side; with --session FILE, it sends
+// the lines of the file instead and prints the replies.
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <poll.h>
+#include <sys/un.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <chrono>
+
+#include "engine.hpp"
+#include "thread_pool.hpp"
+#include "util.hpp"
+#include "trace.hpp"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+typedef std::function< void(const std::string&) > Output;
+
+// deeper searches do not finish anyway
+const int MAX_DEPTH = 64;
+
+// all output lines of stdin mode, also from the search thread
+std::mutex outputMutex;
+
+void sendStdout(const std::string& line) {
+  std::lock_guard< std::mutex > lock(outputMutex);
+  std::cout << line << std::endl;
+}
+
+/// limits of a 'go' command
+struct GoLimits {
+  int depth;
+  uint64_t nodes;
+  int64_t movetime;
+  bool infinite() const {
+    return this->depth == MAX_DEPTH && this->nodes == 0 && this->movetime <= 0;
+  }
+};
+
+/// parse 'go [depth N] [movetime MS] [nodes N] [infinite]'
+GoLimits parseGo(const std::string& args) {
+  GoLimits limits;
+  limits.depth = MAX_DEPTH;
+  limits.nodes = 0;
+  limits.movetime = 0;
+  std::stringstream in(args);
+  std::string token;
+  while (in >> token) {
+    if (token == "depth") {
+      in >> limits.depth;
+      limits.depth = std::min(std::max(limits.depth, 1), MAX_DEPTH);
+    } else if (token == "movetime") {
+      in >> limits.movetime;
+    } else if (token == "nodes") {
+      in >> limits.nodes;
+    }
+  }
+  return limits;
+}
+
+/// a finished iteration
+struct Analysis {
+  int depth;
+  int score;
+  std::vector< std::string > pv;
+};
+
+/// results of finished iterations, shared by all searches
+/**
+ the key is the position hash combined with the engine settings that
+ change ratings. positions reached by different move orders share their
+ entry, although repetition cutoffs may differ between them; this is
+ the usual inaccuracy of a hash table. the table is split into shards
+ with a lock each, and a full shard drops an arbitrary entry.
+ */
+class AnalysisCache {
+  public:
+    AnalysisCache(size_t capacity)
+        : _shards(SHARDS),
+          _capacityPerShard(std::max(size_t(1), capacity / SHARDS)),
+          _hits(0) {
+    }
+    static uint64_t key(KBX::Game& game) {
+      std::stringstream strategy;
+      strategy << game.getStrategy();
+      return game.hash() ^ (std::hash< std::string >()(strategy.str()) * 0x9e3779b97f4a7c15ULL)
+          ^ game.repetitionDraw();
+    }
+    bool lookup(uint64_t key, Analysis& analysis) {
+      Shard& shard = this->_shards[key % SHARDS];
+      std::lock_guard< std::mutex > lock(shard.mutex);
+      std::unordered_map< uint64_t, Analysis >::iterator it = shard.entries.find(key);
+      if (it == shard.entries.end()) {
+        return false;
+      }
+      this->_hits++;
+      analysis = it->second;
+      return true;
+    }
+    /// store analysis, unless a deeper one is known
+    void store(uint64_t key, const Analysis& analysis) {
+      Shard& shard = this->_shards[key % SHARDS];
+      std::lock_guard< std::mutex > lock(shard.mutex);
+      std::unordered_map< uint64_t, Analysis >::iterator it = shard.entries.find(key);
+      if (it != shard.entries.end()) {
+        if (it->second.depth <= analysis.depth) {
+          it->second = analysis;
+        }
+        return;
+      }
+      if (shard.entries.size() >= this->_capacityPerShard) {
+        shard.entries.erase(shard.entries.begin());
+      }
+      shard.entries[key] = analysis;
+    }
+    uint64_t hits() const {
+      return this->_hits;
+    }
+  private:
+    static const size_t SHARDS = 64;
+    struct Shard {
+      std::mutex mutex;
+      std::unordered_map< uint64_t, Analysis > entries;
+    };
+    std::vector< Shard > _shards;
+    size_t _capacityPerShard;
+    std::atomic< uint64_t > _hits;
+};
+
+/// principal variation: best move, then the best replies by searches of decreasing depth
+std::vector< std::string > principalVariation(KBX::Game game, KBX::Move best, int depth) {
+  std::vector< std::string > pv(1, game.moveToString(best));
+  game.playMove(best);
+  for (int d = depth - 1; d > 0; d--) {
+    if (game.getWinner() != KBX::NONE_OF_BOTH || game.isDraw() || game.validMoves().empty()) {
+      break;
+    }
+    KBX::Evaluation eval = game.searchBestMove(d);
+    if (game.searchAborted() || !eval.move) {
+      break;
+    }
+    pv.push_back(game.moveToString(eval.move));
+    game.playMove(eval.move);
+  }
+  return pv;
+}
+
+std::string infoLine(const Analysis& analysis, uint64_t nodes, int64_t ms) {
+  std::string pv = "";
+  for (size_t i = 0; i < analysis.pv.size(); i++) {
+    pv += " " + analysis.pv[i];
+  }
+  return KBX::stringprintf("info depth %d score cp %d nodes %llu time %lld nps %llu pv", analysis.depth,
+                           analysis.score, static_cast< unsigned long long >(nodes), static_cast< long long >(ms),
+                           static_cast< unsigned long long >(nodes * 1000 / (ms + 1))) + pv;
+}
+
+/// iterative deepening, reporting every finished iteration
+/**
+ with a cache, the search starts after the deepest cached iteration and
+ the final result comes with its full principal variation.
+ */
+void search(KBX::Game game, GoLimits go, std::atomic< bool >* stop, Output out, AnalysisCache* cache) {
+  Clock::time_point start = Clock::now();
+  std::vector< KBX::Move > moves = game.validMoves();
+  if (moves.empty() || game.getWinner() != KBX::NONE_OF_BOTH || game.isDraw()) {
+    out("bestmove (none)");
+    return;
+  }
+  KBX::SearchLimits limits;
+  limits.nodes = go.nodes;
+  limits.stop = stop;
+  if (go.movetime > 0) {
+    limits.deadline = start + std::chrono::milliseconds(go.movetime);
+  }
+  game.setSearchLimits(limits);
+  game.resetNodeCount();
+  // fallback, if not even the first iteration finishes
+  Analysis best;
+  best.depth = 0;
+  best.score = 0;
+  best.pv.push_back(game.moveToString(moves[0]));
+  uint64_t key = cache ? AnalysisCache::key(game) : 0;
+  if (cache && cache->lookup(key, best)) {
+    out(infoLine(best, 0, 0));
+  }
+  for (int depth = best.depth + 1; depth <= go.depth; depth++) {
+    KBX::Evaluation eval = game.searchBestMove(depth);
+    if (game.searchAborted() || !eval.move) {
+      break;
+    }
+    best.depth = depth;
+    best.score = static_cast< int >(eval.rating * 100.0f);
+    best.pv.assign(1, game.moveToString(eval.move));
+    if (cache) {
+      cache->store(key, best);
+    }
+    out(infoLine(best, game.nodeCount(), std::chrono::duration_cast< std::chrono::milliseconds >(Clock::now() - start).count()));
+  }
+  if (cache && best.depth > 1 && best.pv.size() == 1) {
+    best.pv = principalVariation(game, game.moveFromString(best.pv[0]), best.depth);
+    cache->store(key, best);
+    out(infoLine(best, game.nodeCount(), std::chrono::duration_cast< std::chrono::milliseconds >(Clock::now() - start).count()));
+  }
+  out("bestmove " + best.pv[0]);
+}
+
+/// handle 'position startpos|kbx <savegame> [moves ...]'
+void position(KBX::Game& current, const std::string& args, Output out) {
+  // the savegame has a "moves" key, but never a blank before it
+  std::string setup = args;
+  std::string moveList = "";
+  size_t sep = (args.compare(0, 6, "moves ") == 0) ? 0 : args.find(" moves");
+  if (sep != std::string::npos) {
+    setup = args.substr(0, sep);
+    moveList = args.substr(sep + 6);
+  }
+  setup = KBX::trim(setup);
+  KBX::Game game((GameConfig()));
+  if (setup.compare(0, 3, "kbx") == 0) {
+    std::stringstream in(setup.substr(3));
+    in >> game;
+    if (in.fail()) {
+      out("info string cannot read savegame");
+      return;
+    }
+  } else if (setup != "startpos") {
+    out("info string unknown position '" + setup + "'");
+    return;
+  }
+  // options override the settings of the savegame
+  game.setRepetitionDraw(current.repetitionDraw());
+  game.getStrategy() = current.getStrategy();
+  game.setRandomSeed(current.randomSeed());
+  std::stringstream moves(moveList);
+  std::string mv;
+  while (moves >> mv) {
+    KBX::Move move = game.moveFromString(mv);
+    if ( !move || game.getDie(move.dieIndex).getColor() != game.getNext() || !game.moveIsValid(move)) {
+      out("info string invalid move '" + mv + "'");
+      return;
+    }
+    game.playMove(move);
+  }
+  current = game;
+}
+
+/// handle 'setoption name <name> value <value>'
+void setOption(KBX::Game& game, const std::string& args, Output out) {
+  size_t sep = args.find(" value ");
+  if (args.compare(0, 5, "name ") != 0 || sep == std::string::npos) {
+    out("info string malformed option");
+    return;
+  }
+  std::string name = KBX::trim(args.substr(5, sep - 5));
+  std::string value = KBX::trim(args.substr(sep + 7));
+  if (name == "RepetitionDraw") {
+    game.setRepetitionDraw(atoi(value.c_str()));
+  } else if (name == "Strategy") {
+    KBX::Strategy strategy;
+    std::stringstream in(value);
+    in >> strategy;
+    if (in.fail()) {
+      out("info string cannot read strategy");
+      return;
+    }
+    game.getStrategy() = strategy;
+  } else if (name == "Seed") {
+    // reproducible choice between equally rated moves (0: random)
+    game.setRandomSeed(strtoull(value.c_str(), NULL, 10));
+  } else {
+    out("info string unknown option '" + name + "'");
+  }
+}
+
+/// split command line into command and arguments
+void splitCommand(const std::string& line, std::string& command, std::string& args) {
+  std::string trimmed = KBX::trim(line);
+  size_t sep = trimmed.find(' ');
+  command = trimmed.substr(0, sep);
+  args = (sep == std::string::npos) ? "" : KBX::trim(trimmed.substr(sep + 1));
+}
+
+/// handle the commands that do not search; false, if the command is none of them
+bool handleSetup(KBX::Game& game, const std::string& command, const std::string& args, Output out) {
+  if (command == "uci") {
+    out("id name Kubix 0.1");
+    out("id author Florian Sittel & Carsten Burgard");
+    out(KBX::stringprintf("option name RepetitionDraw type spin default %d min 0 max 9",
+                          static_cast< int >(game.repetitionDraw())));
+    out("option name Strategy type string default <empty>");
+    out("option name Seed type string default 0");
+    out("uciok");
+  } else if (command == "isready") {
+    out("readyok");
+  } else if (command == "setoption") {
+    setOption(game, args, out);
+  } else if (command == "ucinewgame") {
+    position(game, "startpos", out);
+  } else if (command == "position") {
+    position(game, args, out);
+  } else if (command == "d") {
+    std::stringstream savegame;
+    savegame << game;
+    out("kbx " + savegame.str());
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/// the engine state of stdin mode between commands
+class Engine {
+  public:
+    Engine()
+        : _game((GameConfig())),
+          _stop(false),
+          _infinite(false) {
+    }
+    ~Engine() {
+      this->stop();
+    }
+    void stop() {
+      this->_stop = true;
+      if (this->_searcher.joinable()) {
+        this->_searcher.join();
+      }
+      this->_stop = false;
+    }
+    void go(const GoLimits& limits) {
+      this->stop();
+      this->_infinite = limits.infinite();
+      this->_searcher = std::thread(search, this->_game, limits, &this->_stop, sendStdout, static_cast< AnalysisCache* >(NULL));
+    }
+    /// let a limited search finish, stop an infinite one
+    void finish() {
+      if (this->_infinite) {
+        this->stop();
+      } else if (this->_searcher.joinable()) {
+        this->_searcher.join();
+      }
+    }
+    KBX::Game& game() {
+      return this->_game;
+    }
+  private:
+    KBX::Game _game;
+    std::thread _searcher;
+    std::atomic< bool > _stop;
+    bool _infinite;
+};
+
+int runStdin() {
+  Engine engine;
+  std::string line;
+  while (std::getline(std::cin, line)) {
+    std::string command, args;
+    splitCommand(line, command, args);
+    if (command == "go") {
+      engine.go(parseGo(args));
+    } else if (command == "stop") {
+      engine.stop();
+    } else if (command == "quit") {
+      engine.stop();
+      return 0;
+    } else if (command == "isready" || command == "uci" || command == "d") {
+      handleSetup(engine.game(), command, args, sendStdout);
+    } else {
+      // commands changing the position wait for the search
+      engine.stop();
+      if ( !handleSetup(engine.game(), command, args, sendStdout) && !command.empty()) {
+        sendStdout("info string unknown command '" + command + "'");
+      }
+    }
+  }
+  // end of input: e.g. 'go depth 6' piped into the engine
+  engine.finish();
+  return 0;
+}
+
+/// request latencies in milliseconds, for throughput and percentiles
+class LatencyStats {
+  public:
+    LatencyStats()
+        : _start(Clock::now()) {
+    }
+    void add(double ms) {
+      std::lock_guard< std::mutex > lock(this->_mutex);
+      this->_latencies.push_back(ms);
+    }
+    std::string summary() {
+      std::vector< double > sorted;
+      {
+        std::lock_guard< std::mutex > lock(this->_mutex);
+        sorted = this->_latencies;
+      }
+      std::sort(sorted.begin(), sorted.end());
+      double seconds = std::chrono::duration< double >(Clock::now() - this->_start).count();
+      return KBX::stringprintf("requests %zu rate %.1f/s p50 %.1f ms p99 %.1f ms max %.1f ms", sorted.size(),
+                               sorted.size() / seconds, percentile(sorted, 0.5), percentile(sorted, 0.99),
+                               sorted.empty() ? 0.0 : sorted.back());
+    }
+  private:
+    static double percentile(const std::vector< double >& sorted, double p) {
+      if (sorted.empty()) {
+        return 0.0;
+      }
+      return sorted[std::min(sorted.size() - 1, static_cast< size_t >(p * sorted.size()))];
+    }
+    Clock::time_point _start;
+    std::vector< double > _latencies;
+    std::mutex _mutex;
+};
+
+/// line-based reading and writing on a socket
+class Connection {
+  public:
+    Connection(int fd)
+        : _fd(fd) {
+    }
+    ~Connection() {
+      close(this->_fd);
+    }
+    bool readLine(std::string& line) {
+      while ( !this->takeLine(line)) {
+        if ( !this->_receive()) {
+          return false;
+        }
+      }
+      return true;
+    }
+    /// next complete line from the buffer, without reading the socket
+    bool takeLine(std::string& line) {
+      size_t eol = this->_buffer.find('\n');
+      if (eol == std::string::npos) {
+        return false;
+      }
+      line = this->_buffer.substr(0, eol);
+      this->_buffer.erase(0, eol + 1);
+      return true;
+    }
+    /// buffer whatever arrives within the timeout; false, if the peer has gone
+    bool waitInput(int timeoutMs) {
+      pollfd p;
+      p.fd = this->_fd;
+      p.events = POLLIN;
+      p.revents = 0;
+      if (poll(&p, 1, timeoutMs) <= 0) {
+        return true;
+      }
+      return this->_receive();
+    }
+    bool writeLine(const std::string& line) {
+      std::string data = line + "\n";
+      size_t sent = 0;
+      while (sent < data.size()) {
+        ssize_t n = send(this->_fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+          return false;
+        }
+        sent += n;
+      }
+      return true;
+    }
+  private:
+    bool _receive() {
+      char chunk[4096];
+      ssize_t n = recv(this->_fd, chunk, sizeof(chunk), 0);
+      if (n <= 0) {
+        return false;
+      }
+      this->_buffer.append(chunk, n);
+      return true;
+    }
+    int _fd;
+    std::string _buffer;
+};
+
+/// address of a Unix domain socket; false, if the path is too long
+bool socketAddress(const std::string& path, sockaddr_un& addr) {
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    std::cerr << "socket path too long: '" << path << "'" << std::endl;
+    return false;
+  }
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+  return true;
+}
+
+/// one session per connection; searches run on the shared pool
+void serveConnection(int fd, KBX::ThreadPool& pool, AnalysisCache& cache, LatencyStats& stats) {
+  Connection conn(fd);
+  KBX::Game game((GameConfig()));
+  Output out = [&conn](const std::string& line) {
+    conn.writeLine(line);
+  };
+  // commands that arrive during a search are answered after 'bestmove'
+  std::deque< std::string > pending;
+  bool connected = true;
+  std::string line;
+  for (;;) {
+    if ( !pending.empty()) {
+      line = pending.front();
+      pending.pop_front();
+    } else if ( !connected || !conn.readLine(line)) {
+      break;
+    }
+    std::string command, args;
+    splitCommand(line, command, args);
+    if (command == "go") {
+      GoLimits limits = parseGo(args);
+      if (limits.infinite()) {
+        out("info string go needs depth, movetime or nodes in server mode");
+        out("bestmove (none)");
+        continue;
+      }
+      // the session waits for its search, so replies keep the order of the requests.
+      // meanwhile it keeps reading, so 'stop', 'quit' or a closed connection
+      // end the search instead of leaving it to hold a pool thread.
+      Clock::time_point arrival = Clock::now();
+      std::atomic< bool > stop(false);
+      std::shared_ptr< std::promise< void > > finished(new std::promise< void >());
+      std::future< void > done = finished->get_future();
+      pool.submit([&game, &limits, &stop, &out, &cache, finished]() {
+        search(game, limits, &stop, out, &cache);
+        finished->set_value();
+      });
+      while (connected && done.wait_for(std::chrono::milliseconds(0)) != std::future_status::ready) {
+        connected = conn.waitInput(10);
+        std::string next, nextCommand, nextArgs;
+        while (conn.takeLine(next)) {
+          splitCommand(next, nextCommand, nextArgs);
+          if (nextCommand == "stop") {
+            stop = true;
+          } else {
+            if (nextCommand == "quit") {
+              stop = true;
+            }
+            pending.push_back(next);
+          }
+        }
+        if ( !connected) {
+          stop = true;
+        }
+      }
+      done.wait();
+      stats.add(std::chrono::duration< double, std::milli >(Clock::now() - arrival).count());
+    } else if (command == "stats") {
+      out("stats " + stats.summary() + KBX::stringprintf(" cache-hits %llu", static_cast< unsigned long long >(cache.hits())));
+    } else if (command == "stop") {
+      // the search it was meant for has already finished
+    } else if (command == "quit") {
+      break;
+    } else if ( !handleSetup(game, command, args, out) && !command.empty()) {
+      out("info string unknown command '" + command + "'");
+    }
+  }
+}
+
+int runServer(const std::string& path, size_t nThreads, size_t cacheSize) {
+  sockaddr_un addr;
+  if ( !socketAddress(path, addr)) {
+    return 1;
+  }
+  int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  unlink(path.c_str());
+  if (listener < 0 || bind(listener, (sockaddr*) &addr, sizeof(addr)) != 0 || listen(listener, 128) != 0) {
+    std::cerr << "cannot listen on '" << path << "': " << strerror(errno) << std::endl;
+    return 1;
+  }
+  KBX::ThreadPool pool(nThreads);
+  AnalysisCache cache(cacheSize);
+  LatencyStats stats;
+  std::cerr << "listening on '" << path << "' with " << nThreads << " workers" << std::endl;
+  for (;;) {
+    int fd = accept(listener, NULL, NULL);
+    if (fd < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      std::cerr << "accept failed: " << strerror(errno) << std::endl;
+      break;
+    }
+    // sessions mostly wait for the pool, so a thread per connection is cheap
+    std::thread(serveConnection, fd, std::ref(pool), std::ref(cache), std::ref(stats)).detach();
+  }
+  close(listener);
+  return 1;
+}
+
+/// send the lines of a file to a server and print its replies
+/**
+ after 'go' and 'isready', the client waits for 'bestmove' and 'readyok',
+ so later commands do not cancel the search. the session should end with
+ 'quit'; the replies are read until the server closes the connection.
+ */
+int runSession(const std::string& path, const std::string& sessionFile) {
+  sockaddr_un addr;
+  if ( !socketAddress(path, addr)) {
+    return 1;
+  }
+  std::ifstream session(sessionFile);
+  if ( !session.is_open()) {
+    std::cerr << "cannot open '" << sessionFile << "'" << std::endl;
+    return 1;
+  }
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0 || connect(fd, (sockaddr*) &addr, sizeof(addr)) != 0) {
+    std::cerr << "cannot connect to '" << path << "': " << strerror(errno) << std::endl;
+    if (fd >= 0) {
+      close(fd);
+    }
+    return 1;
+  }
+  Connection conn(fd);
+  std::string line, reply;
+  while (std::getline(session, line)) {
+    if ( !conn.writeLine(line)) {
+      std::cerr << "connection to server lost" << std::endl;
+      return 1;
+    }
+    std::string command, args;
+    splitCommand(line, command, args);
+    std::string answer = (command == "go") ? "bestmove" : (command == "isready") ? "readyok" : "";
+    while ( !answer.empty()) {
+      if ( !conn.readLine(reply)) {
+        std::cerr << "connection to server lost" << std::endl;
+        return 1;
+      }
+      std::cout << reply << std::endl;
+      if (reply.compare(0, answer.size(), answer) == 0) {
+        break;
+      }
+    }
+  }
+  while (conn.readLine(reply)) {
+    std::cout << reply << std::endl;
+  }
+  return 0;
+}
+
+/// concurrent clients sending random positions to a server; prints throughput and latency
+int runClients(const std::string& path, size_t nClients, size_t nRequests, const std::string& goArgs, uint64_t seed) {
+  sockaddr_un addr;
+  if ( !socketAddress(path, addr)) {
+    return 1;
+  }
+  LatencyStats stats;
+  std::atomic< size_t > next(0);
+  std::atomic< bool > failed(false);
+  std::vector< std::thread > clients;
+  for (size_t c = 0; c < nClients; c++) {
+    clients.push_back(std::thread([&]() {
+      int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+      if (fd < 0 || connect(fd, (sockaddr*) &addr, sizeof(addr)) != 0) {
+        std::cerr << "cannot connect to '" << path << "': " << strerror(errno) << std::endl;
+        failed = true;
+        if (fd >= 0) {
+          close(fd);
+        }
+        return;
+      }
+      Connection conn(fd);
+      for (size_t r = next++; r < nRequests && !failed; r = next++) {
+        // every request has its own random opening of 0 to 7 plies
+        std::mt19937_64 rng(seed + r);
+        KBX::Game game((GameConfig()));
+        std::string moves = "";
+        for (size_t ply = rng() % 8; ply > 0; ply--) {
+          std::vector< KBX::Move > valid = game.validMoves();
+          if (valid.empty() || game.getWinner() != KBX::NONE_OF_BOTH) {
+            break;
+          }
+          KBX::Move move = valid[rng() % valid.size()];
+          moves += " " + game.moveToString(move);
+          game.playMove(move);
+        }
+        Clock::time_point sent = Clock::now();
+        if ( !conn.writeLine("position startpos moves" + moves) || !conn.writeLine("go " + goArgs)) {
+          failed = true;
+          break;
+        }
+        std::string line;
+        while (conn.readLine(line) && line.compare(0, 8, "bestmove") != 0) {
+        }
+        if (line.compare(0, 8, "bestmove") != 0) {
+          failed = true;
+          break;
+        }
+        stats.add(std::chrono::duration< double, std::milli >(Clock::now() - sent).count());
+      }
+      conn.writeLine("quit");
+    }));
+  }
+  for (size_t c = 0; c < clients.size(); c++) {
+    clients[c].join();
+  }
+  if (failed) {
+    std::cerr << "connection to server lost" << std::endl;
+    return 1;
+  }
+  std::cout << "clients " << nClients << " " << stats.summary() << std::endl;
+  return 0;
+}
+
+void usage() {
+  std::cerr << "usage: kubix_uci [--trace FILE]          protocol on stdin/stdout (see kubix_uci.cpp)" << std::endl
+            << "       kubix_uci --server SOCKET [--threads N] [--cache N]" << std::endl
+            << "       kubix_uci --connect SOCKET [--clients N] [--requests N] [--go ARGS] [--seed N]" << std::endl
+            << "       kubix_uci --connect SOCKET --session FILE" << std::endl
+            << "  --server    serve the protocol on a Unix domain socket" << std::endl
+            << "  --threads   number of searches running at once (default: all cores)" << std::endl
+            << "  --cache     number of positions in the shared analysis cache (default 1000000)" << std::endl
+            << "  --connect   load test of a server: print throughput and latency" << std::endl
+            << "  --clients   number of concurrent connections (default 8)" << std::endl
+            << "  --requests  total number of searches (default 1000)" << std::endl
+            << "  --go        limits of every search (default 'depth 4')" << std::endl
+            << "  --seed      seed of the random positions (default 1)" << std::endl
+            << "  --session   send the lines of this file and print the replies" << std::endl
+            << "  --trace     write Chrome trace events of the searches to this file on exit" << std::endl;
+}
+
+} // end anonymous namespace
+
+int main(int argc, char** argv) {
+  std::string serverPath = "";
+  std::string connectPath = "";
+  size_t nThreads = std::max(1u, std::thread::hardware_concurrency());
+  size_t cacheSize = 1000000;
+  size_t nClients = 8;
+  size_t nRequests = 1000;
+  std::string goArgs = "depth 4";
+  uint64_t seed = 1;
+  std::string traceFile = "";
+  std::string sessionFile = "";
+  for (int i = 1; i < argc; i++) {
+    std::string arg(argv[i]);
+    if (i + 1 >= argc) {
+      usage();
+      return 1;
+    }
+    std::string val(argv[++i]);
+    if (arg == "--server") {
+      serverPath = val;
+    } else if (arg == "--connect") {
+      connectPath = val;
+    } else if (arg == "--threads") {
+      nThreads = std::max(1, atoi(val.c_str()));
+    } else if (arg == "--cache") {
+      cacheSize = std::max(1, atoi(val.c_str()));
+    } else if (arg == "--clients") {
+      nClients = std::max(1, atoi(val.c_str()));
+    } else if (arg == "--requests") {
+      nRequests = atoi(val.c_str());
+    } else if (arg == "--go") {
+      goArgs = val;
+    } else if (arg == "--seed") {
+      seed = strtoull(val.c_str(), NULL, 10);
+    } else if (arg == "--trace") {
+      traceFile = val;
+    } else if (arg == "--session") {
+      sessionFile = val;
+    } else {
+      usage();
+      return 1;
+    }
+  }
+  if ( !serverPath.empty()) {
+    return runServer(serverPath, nThreads, cacheSize);
+  }
+  if ( !connectPath.empty() && !sessionFile.empty()) {
+    return runSession(connectPath, sessionFile);
+  }
+  if ( !connectPath.empty()) {
+    return runClients(connectPath, nClients, nRequests, goArgs, seed);
+  }
+  if ( !traceFile.empty()) {
+    KBX::Trace::start(traceFile);
+  }
+  int result = runStdin();
+  KBX::Trace::stop();
+  return result;
+}
@@ -7,7 +7,10 @@
 #include <QSpacerItem>
 
 MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent) {
+    : QMainWindow(parent),
+      _connected(NULL),
+      _nGames(0),
+      _randomSeed(0) {
   ui.setupUi(this);
   this->_statusMsg.setText("please do your move");
   // empty widget as space-holder
@@ -15,6 +18,108 @@ MainWindow::MainWindow(QWidget *parent)
   this->statusBar()->addPermanentWidget( &this->_statusMsg, 300);
   //TODO: implement networking and chat to use this...
   ui.chatDock->setVisible(false);
+  QObject::connect(ui.games, SIGNAL(currentChanged(int)), this, SLOT(selectGame(int)));
+  QObject::connect(ui.games, SIGNAL(tabCloseRequested(int)), this, SLOT(closeGame(int)));
+  this->addGame();
+}
+
+/// game of the current tab
+KBX::GameWidget* MainWindow::currentGame() {
+  return static_cast< KBX::GameWidget* >(ui.games->currentWidget());
+}
+
+/// reproducible engine moves in all games, including those opened later (0: random)
+void MainWindow::setRandomSeed(uint64_t seed) {
+  this->_randomSeed = seed;
+  for (int i = 0; i < ui.games->count(); i++) {
+    static_cast< KBX::GameWidget* >(ui.games->widget(i))->setRandomSeed(seed);
+  }
+}
+
+/// opening book of all games, including those opened later; not stored in the settings
+void MainWindow::setOpeningBook(const std::string& bookFile) {
+  this->_openingBook = bookFile;
+  for (int i = 0; i < ui.games->count(); i++) {
+    static_cast< KBX::GameWidget* >(ui.games->widget(i))->setOpeningBook(bookFile);
+  }
+}
+
+/// open another board in a new tab; all games search on the same engine pool
+void MainWindow::addGame() {
+  KBX::GameWidget* game = new KBX::GameWidget(ui.games);
+  game->setAutosave(false);
+  game->setRandomSeed(this->_randomSeed);
+  if ( !this->_openingBook.empty()) {
+    game->setOpeningBook(this->_openingBook);
+  }
+  QObject::connect(game, SIGNAL(newStatus(QString)), this, SLOT(setStatus(QString)));
+  QObject::connect(this, SIGNAL(exitGame()), game, SLOT(cancelEvaluation()));
+  this->_nGames++;
+  ui.games->setCurrentIndex(ui.games->addTab(game, QString("Game %1").arg(this->_nGames)));
+}
+
+/// close the board of the given tab (the last one stays open)
+void MainWindow::closeGame(int index) {
+  if (ui.games->count() < 2) {
+    return;
+  }
+  KBX::GameWidget* game = static_cast< KBX::GameWidget* >(ui.games->widget(index));
+  if (game == this->_connected) {
+    this->_connectGame(game, false);
+  }
+  ui.games->removeTab(index);
+  this->_status.remove(game);
+  // stops its searches; jobs still queued in the engine pool are dropped
+  delete game;
+}
+
+/// connect the menu actions to the game of the current tab
+void MainWindow::selectGame(int index) {
+  KBX::GameWidget* game = static_cast< KBX::GameWidget* >(ui.games->widget(index));
+  if (this->_connected) {
+    this->_connectGame(this->_connected, false);
+  }
+  if (game) {
+    this->_connectGame(game, true);
+    this->_statusMsg.setText(this->_status.value(game, "please do your move"));
+  }
+}
+
+void MainWindow::_connectGame(KBX::GameWidget* game, bool connected) {
+  struct Link {
+    QObject* sender;
+    const char* signal;
+    const char* slot;
+  } links[] = {
+    {ui.action_Open_File, SIGNAL(triggered()), SLOT(load())},
+    {ui.action_Save_Game, SIGNAL(triggered()), SLOT(save())},
+    {ui.action_Give_Up, SIGNAL(triggered()), SLOT(giveUp())},
+    {ui.action_Undo, SIGNAL(triggered()), SLOT(undoLastMove())},
+    {ui.action_Redo, SIGNAL(triggered()), SLOT(redoLastMove())},
+    {ui.action_Pause, SIGNAL(triggered()), SLOT(togglePause())},
+    {ui.action_Move_Now, SIGNAL(triggered()), SLOT(moveNow())},
+    {ui.action_Move_Hints, SIGNAL(toggled(bool)), SLOT(setMoveHints(bool))},
+    {ui.action_Animation_Speed, SIGNAL(triggered()), SLOT(cycleAnimationSpeed())},
+    {this, SIGNAL(newGame(GameConfig)), SLOT(newGame(GameConfig))},
+    {this, SIGNAL(loadGame(std::string)), SLOT(load(std::string))}
+  };
+  for (size_t i = 0; i < sizeof(links) / sizeof(links[0]); i++) {
+    if (connected) {
+      QObject::connect(links[i].sender, links[i].signal, game, links[i].slot);
+    } else {
+      QObject::disconnect(links[i].sender, links[i].signal, game, links[i].slot);
+    }
+  }
+  // the game on display is the one restored on the next start
+  game->setAutosave(connected);
+  if (connected) {
+    ui.action_Move_Hints->blockSignals(true);
+    ui.action_Move_Hints->setChecked(game->moveHints());
+    ui.action_Move_Hints->blockSignals(false);
+    this->_connected = game;
+  } else {
+    this->_connected = NULL;
+  }
 }
 
 void MainWindow::closeEvent(QCloseEvent* event) {
@@ -41,12 +146,12 @@ void MainWindow::showNewGameDialog() {
 
 
 void MainWindow::startNewGame(GameConfig c) {
-  // just send the signal on to the game widget
+  // just send the signal on to the game widget of the current tab
   emit this->newGame(c);
 }
 
 void MainWindow::loadGameFromFile(std::string ifname) {
-  // just send the signal on to the game widget
+  // just send the signal on to the game widget of the current tab
   emit this->loadGame(ifname);
 }
 
@@ -55,6 +160,13 @@ void MainWindow::reloadSettings() {
   emit this->settingsChanged();
 }
 
+/// status line; messages of games in other tabs are kept until their tab is shown
 void MainWindow::setStatus(QString msg) {
-  this->_statusMsg.setText(msg);
+  QObject* game = this->sender();
+  if (game) {
+    this->_status[game] = msg;
+  }
+  if ( !game || game == this->currentGame()) {
+    this->_statusMsg.setText(msg);
+  }
 }
@@ -2,15 +2,20 @@
 #define MAINWINDOW_HPP_
 
 #include <QLabel>
+#include <QHash>
 
 #include "ui_mainWindow.h"
 #include "config.hpp"
+#include "game_widget.hpp"
 
 class MainWindow: public QMainWindow {
     Q_OBJECT
     
   public:
     MainWindow(QWidget *parent = 0);
+    KBX::GameWidget* currentGame();
+    void setRandomSeed(uint64_t seed);
+    void setOpeningBook(const std::string& bookFile);
 				   
   public slots:
     void showAboutDialog();
@@ -20,6 +25,9 @@ class MainWindow: public QMainWindow {
     void startNewGame(GameConfig c);
     void loadGameFromFile(std::string ifname);
     void setStatus(QString msg);
+    void addGame();
+    void closeGame(int index);
+    void selectGame(int index);
     
   signals:
     void loadGame(std::string ifname);
@@ -33,6 +41,15 @@ class MainWindow: public QMainWindow {
   private:
     Ui::MainWindow ui;
     QLabel _statusMsg;
+    // latest status of every game, only the one of the current game is shown
+    QHash< QObject*, QString > _status;
+    // game the menu actions are connected to
+    KBX::GameWidget* _connected;
+    int _nGames;
+    uint64_t _randomSeed;
+    // opening book replacing the one in the settings ("": as configured)
+    std::string _openingBook;
+    void _connectGame(KBX::GameWidget* game, bool connected);
 };
 
 #endif
@@ -20,6 +20,7 @@
 #include <iostream>
 #include <cassert>
 #include <map>
+#include <algorithm>
 
 #include <GL/glu.h>
 
@@ -27,6 +28,8 @@
 #include "game_widget.hpp"
 #include "tools.hpp"
 #include "engine.hpp"
+#include "trace.hpp"
+#include "alloc.hpp"
 
 namespace KBX {
   /// constructor initializing to pos=(0,0,0) and target=(0,1,0)
@@ -304,6 +307,29 @@ namespace KBX {
   //}
 
   // set texture loading flag to false initially
+  int Die::_animationSpeed = 1;
+
+  void Die::setAnimationSpeed(int speed) {
+    Die::_animationSpeed = std::max(0, speed);
+  }
+
+  int Die::animationSpeed() {
+    return Die::_animationSpeed;
+  }
+
+  /// number of frames of an animation; fewer with higher speed
+  int Die::_animationSteps() {
+    if (Die::_animationSpeed == 0) {
+      return 1;
+    }
+    return std::max(1, 15 / Die::_animationSpeed);
+  }
+
+  /// time between frames of an animation in ms
+  int Die::_animationIntervall() {
+    return (Die::_animationSpeed == 0) ? 0 : 20;
+  }
+
   bool Die::texturesLoaded = false;
   GLuint Die::textures[14];
 
@@ -542,6 +568,8 @@ namespace KBX {
 
   /// perform changes due to animations
   void Die::_animate() {
+    KBX_TRACE_SCOPE("Die::animate", "animation");
+    KBX_ALLOC_SITE("Die::animate");
     if ( !this->_animationQueue.empty()) {
       this->_scene->enableAutoUpdate();
       Animation* a = this->_animationQueue.front();
@@ -576,8 +604,8 @@ namespace KBX {
 
   Die::KillAnimation::KillAnimation(Die& die) :
     Animation(die),
-    _animationIntervall(20),
-    _animationSteps(15),
+    _animationIntervall(Die::_animationIntervall()),
+    _animationSteps(Die::_animationSteps()),
     _stepsDone(0)
   {
     this->_parent._pos.z = 0;
@@ -587,7 +615,8 @@ namespace KBX {
 
   void Die::KillAnimation::progress(){
     if (this->_timer.elapsed() >= this->_animationIntervall) {
-      this->_parent._pos.z -= 0.1;
+      // sink 1.5 in total
+      this->_parent._pos.z -= 1.5f / this->_animationSteps;
       this->_stepsDone++;
       this->_timer.restart();
     }
@@ -604,8 +633,8 @@ namespace KBX {
 
   Die::ResurrectAnimation::ResurrectAnimation(Die& die) :
     Animation(die),
-    _animationIntervall(20),
-    _animationSteps(15),
+    _animationIntervall(Die::_animationIntervall()),
+    _animationSteps(Die::_animationSteps()),
     _stepsDone(0)
   {
     this->_parent._pos.z = -1.5;
@@ -616,7 +645,7 @@ namespace KBX {
   void Die::ResurrectAnimation::progress(){
     if (this->_timer.elapsed() >= this->_animationIntervall) {
       if(this->_parent.getTile()->isFree()){
-        this->_parent._pos.z += 0.1;
+        this->_parent._pos.z += 1.5f / this->_animationSteps;
         this->_stepsDone++;
       }
       this->_timer.restart();
@@ -635,8 +664,8 @@ namespace KBX {
   Die::RollAnimation::RollAnimation(Die& die, Direction d) :
     Animation(die),
     _d(d),
-    _animationIntervall(20),
-    _animationSteps(15),
+    _animationIntervall(Die::_animationIntervall()),
+    _animationSteps(Die::_animationSteps()),
     _stepsDone(0),
     _rotAngle(0.0f) {
     this->_radial = Die::RollAnimation::_radials[d];
@@ -712,6 +741,7 @@ namespace KBX {
   }
 
   void Die::rollOverFields(RelativeMove relMove) {
+    KBX_ALLOC_SITE("Die::rollOverFields");
     this->_isMoving = true;
     // generate vertical and horizontal roll animations
     std::queue< Die::RollAnimation* > horizontal;
@@ -760,16 +790,28 @@ namespace KBX {
   }
 
   Color Path::NORMAL_COLOR = ColorTable::YELLOW;
+  Color Path::BEST_MOVE_COLOR = ColorTable::GREEN;
 
   Path::Path(Scene* scene, Vec posFrom, Move move)
     : Model(scene, posFrom),
-      _move(move) {
+      _move(move),
+      _color(NORMAL_COLOR) {
+  }
+
+  Path::Path(Scene* scene, Vec posFrom, Move move, Color color)
+    : Model(scene, posFrom),
+      _move(move),
+      _color(color) {
   }
 
   Move Path::getMove() {
     return this->_move;
   }
 
+  void Path::setColor(Color color) {
+    this->_color = color;
+  }
+
   //Path::Path(Scene* scene, Vec posFrom, RelativeMove relMove, bool isMainPath)
   //    : Model(scene, posFrom),
   //      _move(relMove),
@@ -781,7 +823,7 @@ namespace KBX {
     //  if (this->_isMainPath) {
     //    Path::MAIN_COLOR.setAsGlColor();
     //  } else {
-    Path::NORMAL_COLOR.setAsGlColor();
+    this->_color.setAsGlColor();
     //  }
   }
 
@@ -1526,6 +1568,10 @@ namespace KBX {
     d->addAnimation(new Die::ResurrectAnimation(*d));
   }
 
+  Model* Scene::get(size_t objId) {
+    return this->_objList[objId];
+  }
+
   Die* Scene::getDie(int dieId) {
     return this->_dice[dieId];
   }
@@ -1575,6 +1621,8 @@ namespace KBX {
      \returns Object* to object under mouse cursor
   */
   Model* Scene::pickObject(QPoint p) {
+    KBX_TRACE_SCOPE("Scene::pickObject", "render");
+    KBX_ALLOC_SITE("Scene::pickObject");
     // get resolution from settings
     GLint viewport[4];
     glGetIntegerv(GL_VIEWPORT, viewport);
@@ -172,7 +172,14 @@ class Die: public Model {
     void rollOverFields(RelativeMove relMove);
     bool isMoving();
 
+    // 1: normal, n: n times faster, 0: no animations (every move is done in one frame)
+    static void setAnimationSpeed(int speed);
+    static int animationSpeed();
+
   private:
+    static int _animationSpeed;
+    static int _animationSteps();
+    static int _animationIntervall();
     static GLuint textures[];
     static bool texturesLoaded;
     static void loadTextures();
@@ -253,14 +260,19 @@ class Die: public Model {
 class Path: public Model {
   public:
     Path(Scene* scene, Vec posFrom, Move move);
+    Path(Scene* scene, Vec posFrom, Move move, Color color);
     Move getMove();
+    void setColor(Color color);
 //    Path(Scene* scene, Vec posFrom, Move move, bool isMainPath);
 //    void setAsMainPath();
 //    void setAsNormalPath();
     static Color NORMAL_COLOR;
+    // best move of the running engine search
+    static Color BEST_MOVE_COLOR;
   private:
     //    static const Color MAIN_COLOR;
     Move _move;
+    Color _color;
     //    bool _isMainPath;
     void _render();
     // overwrite general color setting
@@ -335,6 +347,7 @@ class Scene: public Model {
     void killDie(int dieId);
     void resurrectDie(int dieId);
 
+    Model* get(size_t objId);
     Die* getDie(int dieId);
     Tile* getTile(int x, int y);
 
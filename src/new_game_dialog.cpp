@@ -9,6 +9,7 @@ NewGameDialog::NewGameDialog(QWidget *parent)
   // load config from previous session
   Config c(this);
   this->_ui.aiDepth->setValue(c.getAiDepth());
+  this->_ui.repetitionDraw->setValue(c.getRepetitionDraw());
   this->_ui.playMode->setCurrentIndex(c.getPlayMode());
   this->_ui.allowUndoRedo->setChecked(c.getAllowUndoRedo());
   QObject::connect(this, SIGNAL(newGame(GameConfig)), this->parent(), SLOT(startNewGame(GameConfig)));
@@ -19,6 +20,7 @@ void NewGameDialog::accept(){
   Config c(this);
 
   c.setAiDepth(this->_ui.aiDepth->value());
+  c.setRepetitionDraw(this->_ui.repetitionDraw->value());
   c.setPlayMode((KBX::PlayMode)(this->_ui.playMode->currentIndex()));
   c.setAllowUndoRedo(this->_ui.allowUndoRedo->isChecked());
   // inform main window about changed settings
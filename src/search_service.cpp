@@ -0,0 +1,176 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <memory>
+
+#include "search_service.hpp"
+#include "trace.hpp"
+
+namespace KBX {
+
+SearchService::Request::Request(uint64_t id, const Game& game, const Callback& done)
+    : id(id),
+      game(game),
+      done(done) {
+}
+
+SearchService::State::State(ThreadPool& pool, size_t queue)
+    : pool(pool),
+      queue(queue),
+      lastId(0),
+      running(0),
+      scheduled(false),
+      stop(false),
+      finish(false),
+      quit(false) {
+}
+
+/**
+ \param pool threads to search on, must outlive the service
+ \param queue pool queue of the jobs (see ThreadPool::addQueue)
+ */
+SearchService::SearchService(ThreadPool& pool, size_t queue)
+    : _state(new State(pool, queue)) {
+}
+
+/// stop the running search and wait for it to end
+/**
+ jobs still queued in the pool find the service gone and return at once.
+ */
+SearchService::~SearchService() {
+  std::unique_lock< std::mutex > lock(this->_state->mutex);
+  this->_state->quit = true;
+  this->_state->requests.clear();
+  this->_state->stop = true;
+  this->_state->idle.wait(lock, [this]() {
+    return this->_state->running == 0;
+  });
+}
+
+/// search the next move of a copy of the given game
+/**
+ requests are searched in order of submission.
+ \returns id of the request, as passed to the callback (never 0)
+ */
+uint64_t SearchService::submit(const Game& game, const Callback& done) {
+  std::shared_ptr< State > state = this->_state;
+  std::lock_guard< std::mutex > lock(state->mutex);
+  uint64_t id = ++state->lastId;
+  state->requests.push_back(Request(id, game, done));
+  if ( !state->scheduled) {
+    state->scheduled = true;
+    state->pool.submit(state->queue, [state]() {
+      SearchService::_work(state);
+    });
+  }
+  return id;
+}
+
+/// abort the running search and drop all waiting requests (does not block)
+void SearchService::cancel() {
+  std::lock_guard< std::mutex > lock(this->_state->mutex);
+  this->_state->requests.clear();
+  if (this->_state->running != 0) {
+    this->_state->stop = true;
+    this->_state->finish = false;
+  }
+}
+
+/// stop the running search early; its callback gets the best move found so far (does not block)
+void SearchService::finish() {
+  std::lock_guard< std::mutex > lock(this->_state->mutex);
+  if (this->_state->running != 0) {
+    this->_state->stop = true;
+    this->_state->finish = true;
+  }
+}
+
+/// true, if a search is running or waiting
+bool SearchService::busy() {
+  std::lock_guard< std::mutex > lock(this->_state->mutex);
+  return this->_state->running != 0 || !this->_state->requests.empty();
+}
+
+/// latest intermediate result of the running (or last) search, the request id is in SearchInfo::search
+SearchInfo SearchService::progress() const {
+  return this->_state->progress.read();
+}
+
+/// pool job: search the oldest waiting request, then queue a job for the next one
+/**
+ one request per job, so the other queues of the pool get their turn in between.
+ */
+void SearchService::_work(std::shared_ptr< State > state) {
+  std::unique_ptr< Request > request;
+  {
+    std::lock_guard< std::mutex > lock(state->mutex);
+    if (state->quit || state->requests.empty()) {
+      state->scheduled = false;
+      return;
+    }
+    request.reset(new Request(state->requests.front()));
+    state->requests.pop_front();
+    state->running = request->id;
+    state->stop = false;
+    state->finish = false;
+  }
+  KBX_TRACE_SCOPE("SearchService", "engine");
+  state->progress.start(request->id);
+  SearchLimits limits;
+  limits.stop = &state->stop;
+  request->game.setSearchLimits(limits);
+  request->game.setSearchProgress( &state->progress);
+  Move move = request->game.evaluateNext();
+  bool finishing;
+  {
+    std::lock_guard< std::mutex > lock(state->mutex);
+    finishing = state->stop && state->finish;
+  }
+  if (finishing) {
+    SearchInfo info = state->progress.read();
+    if (info.completedMove) {
+      move = info.completedMove;
+    } else if (info.move) {
+      move = info.move;
+    } else {
+      // stopped before any move was rated; depth 1 takes no time
+      request->game.setSearchLimits(SearchLimits());
+      move = request->game.searchBestMove(1).move;
+    }
+  }
+  bool cancelled;
+  {
+    std::lock_guard< std::mutex > lock(state->mutex);
+    cancelled = state->quit || (state->stop && !state->finish);
+  }
+  // still running: the destructor waits for the callback to return
+  if ( !cancelled) {
+    request->done(request->id, move, request->game.searchStats());
+  }
+  std::lock_guard< std::mutex > lock(state->mutex);
+  state->running = 0;
+  state->idle.notify_all();
+  if (state->quit || state->requests.empty()) {
+    state->scheduled = false;
+  } else {
+    state->pool.submit(state->queue, [state]() {
+      SearchService::_work(state);
+    });
+  }
+}
+
+} // end namespace KBX
@@ -0,0 +1,92 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef SEARCH_SERVICE__HPP
+#define SEARCH_SERVICE__HPP
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "engine.hpp"
+#include "thread_pool.hpp"
+
+namespace KBX {
+
+/// searches computer moves on copies of games, one at a time, on a thread pool
+/**
+ submit takes a snapshot of the game, so the caller may go on changing
+ (and drawing) its game while the search runs. requests are run as jobs
+ of the given pool queue, one job per request, so services of several
+ games share the threads of one pool in turn. the result is passed to
+ the callback on a pool thread; a GUI forwards it to its own thread,
+ e.g. by a queued signal. cancel stops the running search within a few
+ hundred nodes (the stop flag is checked at every node, see
+ SearchLimits) and drops waiting requests; their callbacks are not called.
+ while a search runs, progress returns its latest best move without
+ locking; finish stops it early and delivers that move.
+ */
+class SearchService {
+  public:
+    typedef std::function< void(uint64_t request, Move move, const SearchStats& stats) > Callback;
+    SearchService(ThreadPool& pool, size_t queue = 0);
+    ~SearchService();
+    uint64_t submit(const Game& game, const Callback& done);
+    void cancel();
+    void finish();
+    bool busy();
+    SearchInfo progress() const;
+
+  private:
+    class Request {
+      public:
+        Request(uint64_t id, const Game& game, const Callback& done);
+        uint64_t id;
+        Game game;
+        Callback done;
+    };
+    // shared with the pool jobs, which may start after the service is gone
+    class State {
+      public:
+        State(ThreadPool& pool, size_t queue);
+        ThreadPool& pool;
+        size_t queue;
+        std::deque< Request > requests;
+        std::mutex mutex;
+        // signalled when the running request has ended
+        std::condition_variable idle;
+        // id of the last submitted request and of the running one (0: none)
+        uint64_t lastId;
+        uint64_t running;
+        // a pool job for the next request is queued or running
+        bool scheduled;
+        std::atomic< bool > stop;
+        // deliver the best move so far, once the search has stopped
+        bool finish;
+        bool quit;
+        SearchProgress progress;
+    };
+    static void _work(std::shared_ptr< State > state);
+    std::shared_ptr< State > _state;
+};
+
+} // end namespace KBX
+#endif
@@ -8,13 +8,15 @@
 #include <sstream>
 
 #include "engine.hpp"
-#include "tools.hpp"
+#include "util.hpp"
+#include "trace.hpp"
+#include "alloc.hpp"
 
 namespace KBX {
 
   inline bool readTo(std::istream &stream,char end){
     if(stream.tellg() > 0) stream.unget();
-    char c;
+    char c = 0;
     while(stream.good()){
       stream.get(c);
       if(c == end) break;
@@ -68,11 +70,14 @@ namespace KBX {
   }
 
   std::ostream& operator<< (std::ostream &out, const Game& game){
+    KBX_TRACE_SCOPE("writeGame", "io");
+    KBX_ALLOC_SITE("writeGame");
     out << KBX::beginObj;
     out << "\"mode\":" << game._mode << KBX::separator;
     out << "\"next\":" << (KBX::PlayColor)(game._nextPlayer) << KBX::separator;
     out << "\"aiDepth\":" << game._aiDepth << KBX::separator;
     out << "\"aiStrategy\":" << game._strategy << KBX::separator;
+    out << "\"repDraw\":" << game._repetitionDraw << KBX::separator;
     out << "\"dice\":" << KBX::beginList;
     for (size_t i = 0; i < 18; i++) {
       out << game._dice[i];
@@ -119,40 +124,100 @@ namespace KBX {
     stream.seekg(pos);
   }
 
+  /// check, if nothing but white space is left
+  inline bool onlySpaceLeft(std::istream& stream){
+    std::string rest;
+    stream >> rest;
+    return rest.empty();
+  }
+
+  /// read a list of moves; sets failbit, if an entry is no move
   int readMoves(std::istream& stream,std::list<Move>& moves){
     int retval = 0;
-    readTo(stream,KBX::beginList);
-    while(stream.good()){
-      readTo(stream,KBX::beginObj);
+    if(!readTo(stream,KBX::beginList)){
+      stream.setstate(std::ios::failbit);
+      return retval;
+    }
+    bool next = true;
+    while(next){
+      std::stringstream value;
+      next = readNext(stream,value);
+      // only the entry of an empty list is empty
+      if(!next && retval == 0 && KBX::trim(value.str()).empty()) break;
       Move m;
-      stream >> m;
-      if(m){
-	moves.push_back(m);
-	retval++;
+      value >> m;
+      if(value.fail() || !onlySpaceLeft(value)){
+	stream.setstate(std::ios::failbit);
+	return retval;
       }
+      moves.push_back(m);
+      retval++;
     }
     return retval;
   }
 
+  /// read a list of killed dice; sets failbit, if an entry is no number
   int readDeaths(std::istream& stream,std::list<int>& deaths){
     int retval = 0;
-    const int emptyval = -10;
-    readTo(stream,KBX::beginList);
-    while(stream.good()){
-      int id = emptyval;
-      stream >> id;
-      if(id != emptyval){
-	deaths.push_back(id);
-	retval++;
+    if(!readTo(stream,KBX::beginList)){
+      stream.setstate(std::ios::failbit);
+      return retval;
+    }
+    bool next = true;
+    while(next){
+      std::stringstream value;
+      next = readNext(stream,value);
+      if(!next && retval == 0 && KBX::trim(value.str()).empty()) break;
+      int id;
+      value >> id;
+      if(value.fail() || !onlySpaceLeft(value)){
+	stream.setstate(std::ios::failbit);
+	return retval;
       }
-      readTo(stream,KBX::separator);
+      deaths.push_back(id);
+      retval++;
     }
     return retval;
   }
 
+  /// drop the death of die 0 that older versions appended when reading an empty list
+  /**
+   they read '[]' as '[0]', so their savegames may hold one death more
+   than moves, the last one being 0.
+   */
+  void dropStrayDeath(const std::list<Move>& moves, std::list<int>& deaths){
+    if(deaths.size() == moves.size()+1 && deaths.back() == 0){
+      deaths.pop_back();
+    }
+  }
+
+  /// check, if a list of moves and the dice they killed fit each other and the 18 dice
+  bool validHistory(const std::list<Move>& moves, const std::list<int>& deaths){
+    if(moves.size() != deaths.size()) return false;
+    for(auto it = moves.begin(); it != moves.end(); it++){
+      if(it->dieIndex < 0 || it->dieIndex > 17) return false;
+    }
+    for(auto it = deaths.begin(); it != deaths.end(); it++){
+      if(*it != CLEAR && (*it < 0 || *it > 17)) return false;
+    }
+    return true;
+  }
+
+  /// read a savegame; sets failbit (and leaves the board undefined), if it is none
+  /**
+   a savegame is an object with a 'dice' key holding all 18 dice and no
+   unknown keys. its history must replay on the board, i.e. every stored
+   move can be taken back (and every move taken back be redone).
+   */
   std::istream& operator>> (std::istream & stream, Game& game){
-    readTo(stream,KBX::beginObj);
+    KBX_TRACE_SCOPE("readGame", "io");
+    KBX_ALLOC_SITE("readGame");
+    if(!readTo(stream,KBX::beginObj)){
+      stream.setstate(std::ios::failbit);
+      return stream;
+    }
     game.clearBoard();
+    size_t nDice = 0;
     while(stream.good()){
       std::string key;
       std::stringstream value;
@@ -170,15 +235,22 @@ namespace KBX {
 	value >> game._aiDepth;
       } else if(key=="aiStrategy"){
 	value >> game._strategy;
+      } else if(key=="repDraw"){
+	value >> game._repetitionDraw;
       } else if(key=="dice"){
 	for(size_t i=0; i<18; i++){
 	  value >> game._dice[i];
+	  if(value.fail()) break;
 	  if(!game._dice[i].gotKilled()){
 	    game._fields[game._dice[i].x()][game._dice[i].y()] = i;
 	  }
+	  nDice++;
 	}
       } else if(key=="history"){
-	readTo(value,KBX::beginObj);
+	if(!readTo(value,KBX::beginObj)){
+	  stream.setstate(std::ios::failbit);
+	  return stream;
+	}
 	while(value.good()){
 	  std::string subkey;
 	  std::stringstream val;
@@ -192,13 +264,31 @@ namespace KBX {
 	  } else if(subkey=="deathsPending"){
 	    KBX::readDeaths(val,game._deathStackPending);
 	  }
+	  if(val.fail()){
+	    stream.setstate(std::ios::failbit);
+	    return stream;
+	  }
 	  if(!nextSub) break;
 	}
       } else {
-	throw stringprintf("deserialization operator >>&Game: unknown key '%s'",key.c_str()).c_str();
+	// not a savegame (of this version)
+	stream.setstate(std::ios::failbit);
+	return stream;
       }
       if(!next) break;
     }
+    dropStrayDeath(game._moveStack,game._deathStack);
+    dropStrayDeath(game._moveStackPending,game._deathStackPending);
+    if(nDice != 18
+       || !validHistory(game._moveStack,game._deathStack)
+       || !validHistory(game._moveStackPending,game._deathStackPending)){
+      stream.setstate(std::ios::failbit);
+      return stream;
+    }
+    game._computeHash();
+    if(!game._rebuildHistory()){
+      stream.setstate(std::ios::failbit);
+    }
     return stream;
   }
 
@@ -213,24 +303,45 @@ namespace KBX {
     return out;
   }
 
+  /// read a die; sets failbit, if position or state are missing or off the board
   std::istream& operator>> (std::istream &stream, DieState& d){
-    readTo(stream,KBX::beginObj);
+    if(!readTo(stream,KBX::beginObj)){
+      stream.setstate(std::ios::failbit);
+      return stream;
+    }
     std::string key;
+    // x, y and current state are required
+    int nRequired = 0;
+    bool ok = true;
     while(stream.good()){
       std::stringstream value;
       bool next = readNextToken(stream,key,value);
       if(key.empty()) break;
-      if(key=="x")  value >> d._x;
-      if(key=="y")  value >> d._y;
+      if(key=="x"){
+	value >> d._x;
+	nRequired++;
+      }
+      if(key=="y"){
+	value >> d._y;
+	nRequired++;
+      }
       if(key=="col"){
 	int col = 0;
 	value >> col;
 	d._color = (KBX::PlayColor)col;
       }
       if(key=="fS") value >> d._formerState;
-      if(key=="cS") value >> d._curState;
+      if(key=="cS"){
+	value >> d._curState;
+	nRequired++;
+      }
+      ok = ok && !value.fail();
       if(!next) break;
     }
+    if(!ok || nRequired != 3 || d._curState > DEAD
+       || (d._curState != DEAD && (d._x < 0 || d._x > 8 || d._y < 0 || d._y > 8))){
+      stream.setstate(std::ios::failbit);
+    }
     return stream;
   }
 
@@ -243,18 +354,35 @@ namespace KBX {
     return out;
   }
 
+  /// read a relative move; sets failbit, if a distance is missing
   std::istream& operator>> (std::istream &stream, RelativeMove& move){
-    readTo(stream,KBX::beginObj);
+    if(!readTo(stream,KBX::beginObj)){
+      stream.setstate(std::ios::failbit);
+      return stream;
+    }
+    // dx and dy are required
+    int nRequired = 0;
+    bool ok = true;
     while(stream.good()){
       std::string key;
       std::stringstream value;
       bool next = readNextToken(stream,key,value);
       if(key.empty()) break;
-      if(key=="dx") value >> move.dx;
-      if(key=="dy") value >> move.dy;
+      if(key=="dx"){
+	value >> move.dx;
+	nRequired++;
+      }
+      if(key=="dy"){
+	value >> move.dy;
+	nRequired++;
+      }
       if(key=="fX") value >> move.firstX;
+      ok = ok && !value.fail();
       if(!next) break;
     }
+    if(!ok || nRequired != 2){
+      stream.setstate(std::ios::failbit);
+    }
     return stream;
   }
 
@@ -266,19 +394,33 @@ namespace KBX {
     return out;
   }
 
+  /// read a move; sets failbit, if die index or relative move are missing
   std::istream& operator>> (std::istream &stream, Move& move){
-    readTo(stream,KBX::beginObj);
+    if(!readTo(stream,KBX::beginObj)){
+      stream.setstate(std::ios::failbit);
+      return stream;
+    }
+    int nRequired = 0;
+    bool ok = true;
     while(stream.good()){
       std::string key;
       std::stringstream value;
       bool next = readNextToken(stream,key,value);
       if(key.empty()) break;
-      if(key=="idx") value >> move.dieIndex;
+      if(key=="idx"){
+	value >> move.dieIndex;
+	nRequired++;
+      }
       if(key=="rel"){
 	value >> move.rel;
+	nRequired++;
       }
+      ok = ok && !value.fail();
       if(!next) break;
     }
+    if(!ok || nRequired != 2){
+      stream.setstate(std::ios::failbit);
+    }
     return stream;
   }
 
@@ -0,0 +1,96 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+
+#include "thread_pool.hpp"
+
+namespace KBX {
+
+/// start the given number of threads (at least one)
+ThreadPool::ThreadPool(size_t nThreads)
+    : _lastQueue(0),
+      _nQueues(1),
+      _done(false) {
+  for (size_t t = 0; t < std::max< size_t >(nThreads, 1); t++) {
+    this->_workers.push_back(std::thread([this]() {
+      this->_work();
+    }));
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    this->_done = true;
+  }
+  this->_wakeup.notify_all();
+  for (size_t t = 0; t < this->_workers.size(); t++) {
+    this->_workers[t].join();
+  }
+}
+
+/// id of a new queue (queue 0 is shared by all jobs submitted without queue)
+size_t ThreadPool::addQueue() {
+  std::lock_guard< std::mutex > lock(this->_mutex);
+  return this->_nQueues++;
+}
+
+void ThreadPool::submit(const std::function< void() >& job) {
+  this->submit(0, job);
+}
+
+void ThreadPool::submit(size_t queue, const std::function< void() >& job) {
+  {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    this->_queues[queue].push_back(job);
+  }
+  this->_wakeup.notify_one();
+}
+
+size_t ThreadPool::size() const {
+  return this->_workers.size();
+}
+
+void ThreadPool::_work() {
+  for (;;) {
+    std::function< void() > job;
+    {
+      std::unique_lock< std::mutex > lock(this->_mutex);
+      this->_wakeup.wait(lock, [this]() {
+        return this->_done || !this->_queues.empty();
+      });
+      if (this->_queues.empty()) {
+        return;
+      }
+      // round robin over the queues
+      std::map< size_t, std::deque< std::function< void() > > >::iterator queue = this->_queues.upper_bound(this->_lastQueue);
+      if (queue == this->_queues.end()) {
+        queue = this->_queues.begin();
+      }
+      job = queue->second.front();
+      queue->second.pop_front();
+      this->_lastQueue = queue->first;
+      if (queue->second.empty()) {
+        this->_queues.erase(queue);
+      }
+    }
+    job();
+  }
+}
+
+} // end namespace KBX
@@ -0,0 +1,62 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef THREAD_POOL__HPP
+#define THREAD_POOL__HPP
+
+#include <stddef.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace KBX {
+
+/// fixed number of threads working off queues of jobs
+/**
+ every client (e.g. a game) submits to its own queue (see addQueue), and
+ free threads take the next job from the queues in turn, so a client
+ with many jobs cannot starve the others. jobs of one queue are started
+ in order of submission. the destructor finishes all queued jobs before
+ it joins the threads.
+ */
+class ThreadPool {
+  public:
+    ThreadPool(size_t nThreads);
+    ~ThreadPool();
+    size_t addQueue();
+    void submit(const std::function< void() >& job);
+    void submit(size_t queue, const std::function< void() >& job);
+    size_t size() const;
+  private:
+    void _work();
+    std::vector< std::thread > _workers;
+    // non-empty queues by id
+    std::map< size_t, std::deque< std::function< void() > > > _queues;
+    // queue of the last job started, the next job is taken from the queue after it
+    size_t _lastQueue;
+    size_t _nQueues;
+    std::mutex _mutex;
+    std::condition_variable _wakeup;
+    bool _done;
+};
+
+} // end namespace KBX
+#endif
@@ -0,0 +1,124 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <mutex>
+
+#include "trace.hpp"
+
+namespace KBX {
+
+namespace {
+
+struct TraceEvent {
+  const char* name;
+  const char* category;
+  int64_t begin;
+  int64_t duration;
+};
+
+/// events of a single thread; kept alive by the registry after the thread ended
+struct TraceBuffer {
+  int tid;
+  std::mutex mutex;
+  std::vector< TraceEvent > events;
+};
+
+std::mutex registryMutex;
+std::vector< std::shared_ptr< TraceBuffer > > registry;
+std::string traceFile;
+const std::chrono::steady_clock::time_point traceEpoch = std::chrono::steady_clock::now();
+
+TraceBuffer& threadBuffer() {
+  thread_local std::shared_ptr< TraceBuffer > buffer;
+  if ( !buffer) {
+    buffer = std::make_shared< TraceBuffer >();
+    std::lock_guard< std::mutex > lock(registryMutex);
+    buffer->tid = registry.size() + 1;
+    registry.push_back(buffer);
+  }
+  return *buffer;
+}
+
+} // end anonymous namespace
+
+std::atomic< bool > Trace::_enabled(false);
+
+/// start tracing; events are written to filename by stop
+bool Trace::start(const std::string& filename) {
+  std::lock_guard< std::mutex > lock(registryMutex);
+  traceFile = filename;
+  for (size_t i = 0; i < registry.size(); i++) {
+    std::lock_guard< std::mutex > bufferLock(registry[i]->mutex);
+    registry[i]->events.clear();
+  }
+  _enabled = true;
+  return true;
+}
+
+/// stop tracing and write the trace file
+/**
+ \returns false, if tracing was not started or the file cannot be written
+ */
+bool Trace::stop() {
+  if ( !_enabled.exchange(false)) {
+    return false;
+  }
+  std::lock_guard< std::mutex > lock(registryMutex);
+  std::ofstream out(traceFile);
+  out << "{\"traceEvents\":[";
+  bool first = true;
+  for (size_t i = 0; i < registry.size(); i++) {
+    std::lock_guard< std::mutex > bufferLock(registry[i]->mutex);
+    std::vector< TraceEvent >& events = registry[i]->events;
+    for (size_t e = 0; e < events.size(); e++) {
+      out << (first ? "\n" : ",\n") << "{\"name\":\"" << events[e].name << "\",\"cat\":\"" << events[e].category
+          << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << registry[i]->tid << ",\"ts\":" << events[e].begin
+          << ",\"dur\":" << events[e].duration << "}";
+      first = false;
+    }
+    events.clear();
+  }
+  out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  out.close();
+  if (out.fail()) {
+    std::cerr << "cannot write trace '" << traceFile << "'" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/// microseconds since program start
+int64_t Trace::now() {
+  return std::chrono::duration_cast< std::chrono::microseconds >(std::chrono::steady_clock::now() - traceEpoch).count();
+}
+
+void Trace::record(const char* name, const char* category, int64_t beginUs, int64_t durationUs) {
+  if ( !enabled()) {
+    return;
+  }
+  TraceBuffer& buffer = threadBuffer();
+  TraceEvent event = {name, category, beginUs, durationUs};
+  // only contended while the trace is written
+  std::lock_guard< std::mutex > lock(buffer.mutex);
+  buffer.events.push_back(event);
+}
+
+} // end namespace KBX
@@ -0,0 +1,75 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef TRACE__HPP
+#define TRACE__HPP
+
+#include <stdint.h>
+#include <string>
+#include <atomic>
+#include <chrono>
+
+namespace KBX {
+
+/// recording of timed scopes as Chrome trace events (chrome://tracing, ui.perfetto.dev)
+/**
+ tracing is off by default; start switches it on at runtime, stop writes
+ all events recorded so far to the file given to start. every thread
+ records into its own buffer, so traced threads do not wait for each
+ other. while tracing is off, a traced scope costs one relaxed atomic
+ load.
+ */
+class Trace {
+  public:
+    static bool start(const std::string& filename);
+    static bool stop();
+    static bool enabled() {
+      return _enabled.load(std::memory_order_relaxed);
+    }
+    static void record(const char* name, const char* category, int64_t beginUs, int64_t durationUs);
+    static int64_t now();
+  private:
+    static std::atomic< bool > _enabled;
+};
+
+/// traces the time from construction to destruction (see KBX_TRACE_SCOPE)
+class TraceScope {
+  public:
+    TraceScope(const char* name, const char* category)
+        : _name(name),
+          _category(category),
+          _begin(Trace::enabled() ? Trace::now() : -1) {
+    }
+    ~TraceScope() {
+      if (this->_begin >= 0) {
+        Trace::record(this->_name, this->_category, this->_begin, Trace::now() - this->_begin);
+      }
+    }
+  private:
+    const char* _name;
+    const char* _category;
+    int64_t _begin;
+};
+
+} // end namespace KBX
+
+#define KBX_TRACE_CONCAT2(a, b) a ## b
+#define KBX_TRACE_CONCAT(a, b) KBX_TRACE_CONCAT2(a, b)
+/// trace the enclosing scope; name and category must be string literals
+#define KBX_TRACE_SCOPE(name, category) KBX::TraceScope KBX_TRACE_CONCAT(kbxTraceScope, __LINE__)(name, category)
+
+#endif
@@ -0,0 +1,176 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <errno.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <fstream>
+
+#include "training.hpp"
+#include "util.hpp"
+
+namespace KBX {
+
+static_assert(sizeof(TrainingRecord) == 48, "training records must be packed to 48 bytes");
+
+const char TrainingFile::_magic[8] = {'K', 'B', 'X', 'T', 'R', 'A', 'I', 'N'};
+
+static const size_t HEADER_SIZE = sizeof(uint64_t) + 8;
+
+TrainingRecord::TrainingRecord()
+    : next(0),
+      result(0),
+      ply(0),
+      score(0.0f),
+      moveField(NO_FIELD),
+      dx(0),
+      dy(0),
+      firstX(0) {
+  memset(this->field, NO_FIELD, sizeof(this->field));
+  memset(this->state, DEAD, sizeof(this->state));
+}
+
+/// record current position of the game with the result of its search
+TrainingRecord::TrainingRecord(Game& game, uint16_t ply, Evaluation eval)
+    : next(game.getNext()),
+      result(0),
+      ply(ply),
+      score(eval.rating),
+      moveField(NO_FIELD),
+      dx(0),
+      dy(0),
+      firstX(0) {
+  for (size_t i = 0; i < 18; i++) {
+    DieState& die = game.getDie(i);
+    if (die.gotKilled()) {
+      this->field[i] = NO_FIELD;
+      this->state[i] = DEAD;
+    } else {
+      this->field[i] = 9 * die.x() + die.y();
+      this->state[i] = die.getCurrentState();
+    }
+  }
+  if (eval.move) {
+    DieState& die = game.getDie(eval.move.dieIndex);
+    this->moveField = 9 * die.x() + die.y();
+    this->dx = eval.move.rel.dx;
+    this->dy = eval.move.rel.dy;
+    this->firstX = eval.move.rel.firstX;
+  }
+}
+
+/// set final result of the game (NONE_OF_BOTH for a draw)
+void TrainingRecord::setResult(PlayColor winner) {
+  if (winner == NONE_OF_BOTH) {
+    this->result = 0;
+  } else {
+    this->result = (winner == this->next) ? 1 : -1;
+  }
+}
+
+TrainingFile::TrainingFile()
+    : _fd( -1),
+      _nRecords(0) {
+}
+
+TrainingFile::~TrainingFile() {
+  this->close();
+}
+
+/// create (or truncate) training data file for writing
+bool TrainingFile::open(const std::string& filename) {
+  this->close();
+  this->_fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (this->_fd < 0) {
+    Logger("training").warning("cannot create training data file '" + filename + "'");
+    return false;
+  }
+  this->_nRecords = 0;
+  // the number of records in the header is written on close
+  char header[HEADER_SIZE];
+  memset(header, 0, sizeof(header));
+  memcpy(header, _magic, sizeof(_magic));
+  return (pwrite(this->_fd, header, sizeof(header), 0) == (ssize_t) sizeof(header));
+}
+
+/// append records to the file, may be called by several threads at once
+bool TrainingFile::append(const std::vector< TrainingRecord >& records) {
+  if (this->_fd < 0 || records.empty()) {
+    return (this->_fd >= 0);
+  }
+  uint64_t first = this->_nRecords.fetch_add(records.size());
+  off_t offset = HEADER_SIZE + first * sizeof(TrainingRecord);
+  const char* data = (const char*) &records[0];
+  size_t remaining = records.size() * sizeof(TrainingRecord);
+  while (remaining > 0) {
+    ssize_t written = pwrite(this->_fd, data, remaining, offset);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += written;
+    offset += written;
+    remaining -= written;
+  }
+  return true;
+}
+
+/// write number of records to the header and close the file
+bool TrainingFile::close() {
+  if (this->_fd < 0) {
+    return true;
+  }
+  uint64_t nRecords = this->_nRecords;
+  bool success = (pwrite(this->_fd, &nRecords, sizeof(nRecords), sizeof(_magic)) == (ssize_t) sizeof(nRecords));
+  success = (::close(this->_fd) == 0) && success;
+  this->_fd = -1;
+  return success;
+}
+
+/// return number of records written so far
+uint64_t TrainingFile::size() const {
+  return this->_nRecords;
+}
+
+/// read all records of a training data file
+bool TrainingFile::read(const std::string& filename, std::vector< TrainingRecord >& records) {
+  Logger log("training");
+  std::ifstream infile(filename, std::ios::binary);
+  char magic[sizeof(_magic)];
+  uint64_t nRecords;
+  if ( !infile.read(magic, sizeof(magic)) || !infile.read((char*) &nRecords, sizeof(nRecords))
+      || memcmp(magic, _magic, sizeof(_magic)) != 0) {
+    log.warning("'" + filename + "' is not a training data file");
+    return false;
+  }
+  if (nRecords == 0) {
+    return true;
+  }
+  size_t offset = records.size();
+  records.resize(offset + nRecords);
+  if ( !infile.read((char*) &records[offset], nRecords * sizeof(TrainingRecord))) {
+    log.warning("training data file '" + filename + "' is truncated");
+    records.resize(offset);
+    return false;
+  }
+  return true;
+}
+
+} // end namespace KBX
@@ -0,0 +1,84 @@
+/*
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef TRAINING__HPP
+#define TRAINING__HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <atomic>
+
+#include "engine.hpp"
+
+namespace KBX {
+
+/// labeled position of a training data file (fixed size of 48 bytes)
+class TrainingRecord {
+  public:
+    static const uint8_t NO_FIELD = 255;
+    // field (9*x + y) and state of every die; killed dice are on NO_FIELD
+    uint8_t field[18];
+    uint8_t state[18];
+    // player with next move: 1 white, -1 black
+    int8_t next;
+    // final result for the player with next move: 1 won, 0 draw, -1 lost
+    int8_t result;
+    uint16_t ply;
+    // search rating for the player with next move
+    float score;
+    // best move found by the search: field of moving die and relative move
+    uint8_t moveField;
+    int8_t dx;
+    int8_t dy;
+    uint8_t firstX;
+    TrainingRecord();
+    TrainingRecord(Game& game, uint16_t ply, Evaluation eval);
+    void setResult(PlayColor winner);
+};
+
+/// training data file: a header followed by a list of records
+/**
+ records are appended by many threads at once without locking:
+ every call of append reserves a range of the file by an atomic
+ counter and writes it independently of the others.
+ */
+class TrainingFile {
+  public:
+    TrainingFile();
+    ~TrainingFile();
+
+    bool open(const std::string& filename);
+    bool append(const std::vector< TrainingRecord >& records);
+    bool close();
+    uint64_t size() const;
+
+    static bool read(const std::string& filename, std::vector< TrainingRecord >& records);
+
+  private:
+    // copying would close the file twice
+    TrainingFile(const TrainingFile& other);
+    TrainingFile& operator=(const TrainingFile& other);
+
+    static const char _magic[8];
+    int _fd;
+    std::atomic< uint64_t > _nRecords;
+};
+
+} // end namespace KBX
+#endif
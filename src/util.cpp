@@ -0,0 +1,398 @@
+/*  
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <random>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "util.hpp"
+#include "alloc.hpp"
+
+namespace KBX {
+/// return sign of number (-1, 0 or 1)
+/**
+ \returns  1, if sign of x is positive
+ \returns -1, if sign of x is negative
+ \returns  0, if x is zero
+ */
+template< class NumType >
+int sgn(NumType n) {
+  if (n < 0) {
+    return -1;
+  } else if (n == 0) {
+    return 0;
+  } else {
+    return 1;
+  }
+}
+int sgn(float f) {
+  return sgn< float >(f);
+}
+int sgn(int i) {
+  return sgn< int >(i);
+}
+
+int sgnP(float f){
+  if (f == 0){
+    return 1;
+  } else {
+    return sgn(f);
+  }
+}
+
+/// seed that differs from call to call (not reproducible)
+uint64_t clockSeed() {
+  return std::chrono::high_resolution_clock::now().time_since_epoch().count();
+}
+
+/// return a random index in [rangeMin, rangeMax], drawn from the given generator
+std::size_t randomIndex(std::size_t rangeMin, std::size_t rangeMax, std::mt19937_64& random) {
+  std::uniform_int_distribution<std::size_t> dist(rangeMin, rangeMax);
+  return dist(random);
+}
+
+/// return a random index, chosen with probability proportional to its weight
+std::size_t weightedRandomIndex(const std::vector< double >& weights, std::mt19937_64& random) {
+  std::discrete_distribution<std::size_t> dist(weights.begin(), weights.end());
+  return dist(random);
+}
+
+/// swap values of integers a & b
+void swap(int& a, int& b) {
+  int buf = a;
+  a = b;
+  b = buf;
+}
+
+/// initialize logger and give it a name
+/**
+ \param name logger will print this name in the logs
+ errors will be printed to stderr,
+ warnings and infos will be printed to stdout.
+ */
+namespace {
+
+/// bounded lock-free queue of log lines: any number of writers, one reader
+/**
+ every slot carries a sequence number telling whether it is free for the
+ writer at a given position or filled for the reader (see D. Vyukov's
+ bounded MPMC queue). a full queue rejects new lines instead of blocking.
+ */
+class LogRing {
+  public:
+    LogRing(size_t capacity)
+        : _mask(0),
+          _head(0),
+          _tail(0) {
+      size_t size = 2;
+      while (size < capacity) {
+        size *= 2;
+      }
+      this->_mask = size - 1;
+      this->_slots.reset(new Slot[size]);
+      for (size_t i = 0; i < size; i++) {
+        this->_slots[i].sequence.store(i, std::memory_order_relaxed);
+      }
+    }
+    bool push(std::string& line) {
+      size_t pos = this->_head.load(std::memory_order_relaxed);
+      for (;;) {
+        Slot& slot = this->_slots[pos & this->_mask];
+        size_t seq = slot.sequence.load(std::memory_order_acquire);
+        if (seq == pos) {
+          if (this->_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            slot.line.swap(line);
+            slot.sequence.store(pos + 1, std::memory_order_release);
+            return true;
+          }
+        } else if (seq < pos) {
+          // full
+          return false;
+        } else {
+          pos = this->_head.load(std::memory_order_relaxed);
+        }
+      }
+    }
+    /// only called by the writer thread
+    bool pop(std::string& line) {
+      Slot& slot = this->_slots[this->_tail & this->_mask];
+      if (slot.sequence.load(std::memory_order_acquire) != this->_tail + 1) {
+        return false;
+      }
+      line.swap(slot.line);
+      slot.line.clear();
+      slot.sequence.store(this->_tail + this->_mask + 1, std::memory_order_release);
+      this->_tail++;
+      return true;
+    }
+  private:
+    struct Slot {
+      std::atomic< size_t > sequence;
+      std::string line;
+    };
+    std::unique_ptr< Slot[] > _slots;
+    size_t _mask;
+    std::atomic< size_t > _head;
+    size_t _tail;
+};
+
+std::atomic< LogRing* > asyncRing(NULL);
+std::atomic< bool > asyncRunning(false);
+std::atomic< uint64_t > droppedLines(0);
+std::thread asyncWriter;
+
+/// write all queued lines; returns false, if there were none
+bool drainRing(LogRing* ring, std::ostream* out) {
+  std::string line;
+  bool any = false;
+  while (ring->pop(line)) {
+    ( *out) << line;
+    any = true;
+  }
+  if (any) {
+    out->flush();
+  }
+  return any;
+}
+
+/// flushes the queue at program exit
+struct AsyncLogShutdown {
+    ~AsyncLogShutdown() {
+      Logger::disableAsync();
+    }
+} asyncLogShutdown;
+
+} // end anonymous namespace
+
+Logger::Logger(std::string name)
+    : _name(name) {
+}
+// set out stream and error stream to stdout and stderr
+std::ostream* Logger::_out = &std::cout;
+std::ostream* Logger::_err = &std::cerr;
+void Logger::setOut(std::ostream* out) {
+  Logger::_out = out;
+}
+void Logger::setErr(std::ostream* err) {
+  Logger::_err = err;
+}
+
+// logging will be disabled per default
+bool Logger::_infosEnabled = false;
+bool Logger::_debugEnabled = false;
+bool Logger::_warningsEnabled = false;
+bool Logger::_errorsEnabled = true;
+/// use this method to enable info logging
+void Logger::enableInfos() {
+  Logger::_infosEnabled = true;
+}
+/// use this method to disable info logging
+void Logger::disableInfos() {
+  Logger::_infosEnabled = false;
+}
+/// use this method to enable debug logging
+void Logger::enableDebug() {
+  Logger::_debugEnabled = true;
+}
+/// use this method to disable debug logging
+void Logger::disableDebug() {
+  Logger::_debugEnabled = false;
+}
+/// use this method to enable warning logging
+void Logger::enableWarnings() {
+  Logger::_warningsEnabled = true;
+}
+/// use this method to disable warning logging
+void Logger::disableWarnings() {
+  Logger::_warningsEnabled = false;
+}
+/// use this method to enable error logging
+void Logger::enableErrors() {
+  Logger::_errorsEnabled = true;
+}
+/// use this method to disable error logging
+void Logger::disableErrors() {
+  Logger::_errorsEnabled = false;
+}
+/// write log lines through a queue of the given capacity, drained by a background thread
+/**
+ logging threads never wait for the output then; lines not fitting into
+ the queue are dropped (see droppedMessages). call this and disableAsync
+ while no other thread logs, e.g. at startup.
+ */
+void Logger::enableAsync(size_t capacity) {
+  if (asyncRunning) {
+    return;
+  }
+  LogRing* ring = new LogRing(capacity);
+  std::ostream* out = Logger::_out;
+  asyncRunning = true;
+  asyncWriter = std::thread([ring, out]() {
+    while (asyncRunning) {
+      if ( !drainRing(ring, out)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      }
+    }
+  });
+  asyncRing = ring;
+}
+/// write remaining queued lines and log synchronously again
+void Logger::disableAsync() {
+  LogRing* ring = asyncRing.exchange(NULL);
+  if ( !ring) {
+    return;
+  }
+  asyncRunning = false;
+  asyncWriter.join();
+  drainRing(ring, Logger::_out);
+  delete ring;
+}
+/// number of lines dropped because the queue was full
+uint64_t Logger::droppedMessages() {
+  return droppedLines;
+}
+/// return local time as string (formatted once per second and thread)
+std::string Logger::_getTime() {
+  thread_local time_t cachedTime = 0;
+  thread_local char cached[32] = "";
+  time_t now = time(NULL);
+  if (now != cachedTime) {
+    struct tm timeInfo;
+    localtime_r( &now, &timeInfo);
+    strftime(cached, sizeof(cached), "%Y-%m-%d %H:%M:%S", &timeInfo);
+    cachedTime = now;
+  }
+  return std::string(cached);
+}
+std::vector< std::string > Logger::_filters;
+/// show only messages with given name-tag(s)
+void Logger::filter(std::string name) {
+  Logger::_filters.push_back(name);
+}
+/// true, if messages of the given name-tag are shown
+bool Logger::passesFilter(const std::string& name) {
+  if (Logger::_filters.empty()) {
+    return true;
+  }
+  for (size_t i = 0; i < Logger::_filters.size(); i++) {
+    if (name == Logger::_filters[i]) {
+      return true;
+    }
+  }
+  return false;
+}
+/// write message to logfile / stdout
+void Logger::_sendMessage(std::string category, std::string msg) {
+  KBX_ALLOC_SITE("Logger");
+  if ( !Logger::passesFilter(this->_name)) {
+    return;
+  }
+  std::string line = this->_getTime() + "\t" + this->_name + " | " + category + ": " + msg + "\n";
+  LogRing* ring = asyncRing.load(std::memory_order_acquire);
+  if (ring) {
+    if ( !ring->push(line)) {
+      droppedLines++;
+    }
+  } else {
+    ( *this->_out) << line << std::flush;
+  }
+}
+/// write info to logfile / stdout
+void Logger::info(std::string msg) {
+  if (this->_infosEnabled) {
+    this->_sendMessage("INFO", msg);
+  }
+}
+/// write debug output to logfile / stdout
+void Logger::debug(std::string msg) {
+  if (this->_debugEnabled) {
+    this->_sendMessage("DEBUG", msg);
+  }
+}
+/// write warning to logfile / stdout
+void Logger::warning(std::string msg) {
+  if (this->_warningsEnabled) {
+    this->_sendMessage("WARNING", msg);
+  }
+}
+/// write error to logfile / stdout
+void Logger::error(std::string msg) {
+  if (this->_errorsEnabled) {
+    this->_sendMessage("ERROR", msg);
+  }
+}
+
+/// behaves like sprintf(char*, ...), but with c++ strings and returns the result
+/**
+ \param str pattern to be printed to
+ \return resulting string
+ The function internally calls sprintf, but converts the result to a c++ string and returns that one.
+ Problems of memory allocation are taken care of automatically.
+ */
+std::string stringprintf(const std::string& str, ...) {
+  unsigned int size = 256;
+  va_list args;
+  char* buf = (char*) malloc(size * sizeof(char));
+  va_start(args, str);
+  while (true) {
+    // the argument list is consumed by every call of vsnprintf
+    va_list argsCopy;
+    va_copy(argsCopy, args);
+    unsigned int length = vsnprintf(buf, size, str.c_str(), argsCopy);
+    va_end(argsCopy);
+    if (length < size) {
+      break;
+    }
+    size = length + 1;
+    buf = (char*) realloc(buf, size * sizeof(char));
+  }
+  va_end(args);
+  std::string result(buf);
+  free(buf);
+  return result;
+}
+
+bool fileExists(const std::string& filename){
+  std::ifstream ifile(filename);
+  return ifile.good();
+}
+
+bool endsWith(std::string const &fullString, std::string const &ending){
+  if (fullString.length() >= ending.length()) {
+    return (0 == fullString.compare (fullString.length() - ending.length(), ending.length(), ending));
+  } else {
+    return false;
+  }
+}
+  
+std::string trim(const std::string& str){
+  size_t begin = str.find_first_not_of(" \t\n\"'");
+  if(begin == std::string::npos) return "";
+  size_t end = str.find_last_not_of(" \t\n\"'");
+  return str.substr(begin,end-begin+1);
+}
+
+} // end namespace KBX
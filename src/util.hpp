@@ -0,0 +1,111 @@
+/*  
+ Kubix - 3D OpenGL implementation of the board game "Tactix"/"Duell" with AI
+ Copyright (C) 2011  Florian Sittel & Carsten Burgard
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef UTIL__HPP
+#define UTIL__HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iterator>
+#include <random>
+
+template <typename Iter, typename Cont>
+bool is_last(Iter iter, const Cont& cont){
+  return (iter != cont.end()) && (next(iter) == cont.end());
+}
+
+namespace KBX {
+template< class NumType > int sgn(NumType n);
+int sgn(float f);
+int sgn(int i);
+int sgnP(float f);
+
+uint64_t clockSeed();
+std::size_t randomIndex(std::size_t rangeMin, std::size_t rangeMax, std::mt19937_64& random);
+std::size_t weightedRandomIndex(const std::vector< double >& weights, std::mt19937_64& random);
+
+void swap(int& a, int& b);
+
+std::string stringprintf(const std::string& str, ...);
+bool endsWith(std::string const &fullString, std::string const &ending);
+bool fileExists(const std::string& filename);
+std::string trim(const std::string& str);
+
+/// represents a simple logger class, use it instead of cout/cerr-statements!
+class Logger {
+    std::string _name;
+    static std::ostream* _out;
+    static std::ostream* _err;
+    static std::vector< std::string > _filters;
+    static bool _infosEnabled;
+    static bool _debugEnabled;
+    static bool _warningsEnabled;
+    static bool _errorsEnabled;
+    static std::string _getTime();
+    void _sendMessage(std::string category, std::string msg);
+  public:
+    Logger(std::string name);
+    static void setOut(std::ostream* out);
+    static void setErr(std::ostream* err);
+    static void enableAsync(size_t capacity);
+    static void disableAsync();
+    static uint64_t droppedMessages();
+    static bool infosEnabled() {
+      return _infosEnabled;
+    }
+    static bool debugEnabled() {
+      return _debugEnabled;
+    }
+    static bool warningsEnabled() {
+      return _warningsEnabled;
+    }
+    static bool errorsEnabled() {
+      return _errorsEnabled;
+    }
+    static bool passesFilter(const std::string& name);
+    static void enableInfos();
+    static void disableInfos();
+    static void enableDebug();
+    static void disableDebug();
+    static void enableWarnings();
+    static void disableWarnings();
+    static void enableErrors();
+    static void disableErrors();
+    static void filter(std::string name);
+    void info(std::string msg);
+    void debug(std::string msg);
+    void warning(std::string msg);
+    void error(std::string msg);
+};
+
+} // end namespace KBX
+
+// logging with printf-like formatting: while the level is disabled or the
+// name is filtered out, no logger is constructed and no argument is formatted
+#define KBX_LOG_INFO(name, ...) \
+  do { if (KBX::Logger::infosEnabled() && KBX::Logger::passesFilter(name)) { KBX::Logger(name).info(KBX::stringprintf(__VA_ARGS__)); } } while (0)
+#define KBX_LOG_DEBUG(name, ...) \
+  do { if (KBX::Logger::debugEnabled() && KBX::Logger::passesFilter(name)) { KBX::Logger(name).debug(KBX::stringprintf(__VA_ARGS__)); } } while (0)
+#define KBX_LOG_WARNING(name, ...) \
+  do { if (KBX::Logger::warningsEnabled() && KBX::Logger::passesFilter(name)) { KBX::Logger(name).warning(KBX::stringprintf(__VA_ARGS__)); } } while (0)
+#define KBX_LOG_ERROR(name, ...) \
+  do { if (KBX::Logger::errorsEnabled() && KBX::Logger::passesFilter(name)) { KBX::Logger(name).error(KBX::stringprintf(__VA_ARGS__)); } } while (0)
+
+#endif
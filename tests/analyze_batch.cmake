@@ -0,0 +1,17 @@
+# annotate a directory of savegames and check that damaged ones are skipped
+#   cmake -DKUBIX=<Kubix> -DGAMES=<dir> -DREPORT=<file> -P analyze_batch.cmake
+# the directory holds intact.kbx (9 moves) and corrupt_history.kbx
+execute_process(COMMAND ${KUBIX} --analyze ${GAMES} --report ${REPORT} --analysis-depth 1 --threads 2
+  ERROR_VARIABLE errors
+  RESULT_VARIABLE result)
+message("${errors}")
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "batch analysis failed: ${result}")
+endif()
+if(NOT errors MATCHES "cannot read '[^']*corrupt_history.kbx'")
+  message(FATAL_ERROR "damaged savegame not reported")
+endif()
+file(READ ${REPORT} report)
+if(NOT report MATCHES "intact.kbx\t8\t" OR report MATCHES "corrupt_history.kbx")
+  message(FATAL_ERROR "report does not annotate exactly the intact savegame")
+endif()
@@ -0,0 +1,27 @@
+#!/bin/sh
+# run a session file twice against a temporary kubix_uci server; the
+# server must answer both sessions to the end and keep running
+#   uci_server.sh <kubix_uci> <session>
+uci="$1"
+session="$2"
+socket="${TMPDIR:-/tmp}/kubix_uci_test_$$.sock"
+"$uci" --server "$socket" --threads 2 --cache 1000 2>/dev/null &
+server=$!
+trap 'kill $server 2>/dev/null; rm -f "$socket"' EXIT
+n=0
+while [ ! -S "$socket" ]; do
+  n=$((n + 1))
+  if [ $n -gt 50 ]; then
+    echo "server did not start"
+    exit 1
+  fi
+  sleep 0.1
+done
+for run in 1 2; do
+  "$uci" --connect "$socket" --session "$session" || exit 1
+  if ! kill -0 $server 2>/dev/null; then
+    echo "server died"
+    exit 1
+  fi
+done
+echo "server still running"
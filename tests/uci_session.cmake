@@ -0,0 +1,13 @@
+# run a kubix_uci session from a file on stdin and check its replies
+#   cmake -DUCI=<kubix_uci> -DSESSION=<file> -DEXPECT=<regex> -P uci_session.cmake
+execute_process(COMMAND ${UCI}
+  INPUT_FILE ${SESSION}
+  OUTPUT_VARIABLE replies
+  RESULT_VARIABLE result)
+message("${replies}")
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "kubix_uci failed: ${result}")
+endif()
+if(NOT replies MATCHES "${EXPECT}")
+  message(FATAL_ERROR "replies do not match '${EXPECT}'")
+endif()